@@ -4,9 +4,12 @@ PPK2 Recording Analysis Script for UDP Latency Measurement
 
 This script analyzes PPK2 digital channel recordings to calculate UDP transmission latency.
 It detects trigger events on D0 (TX) and D1 (RX) channels and calculates the time difference.
+When the export also contains the current samples, it integrates them to report the energy
+per packet and the average current of the run.
 
 Usage:
     python ppk_record_analysis.py -i udp_softap.csv
+    python ppk_record_analysis.py -i udp_sta_dtim.csv -v 3.6 -l "DTIM PS"
 
 Author: Nordic Semiconductor
 License: LicenseRef-Nordic-5-Clause
@@ -14,8 +17,34 @@ License: LicenseRef-Nordic-5-Clause
 
 import argparse
 import csv
+import json
+import math
+import os
+import statistics
 import sys
-from typing import List, Tuple, Optional
+from typing import Any, Dict, List, Optional
+
+try:
+    import numpy as np
+    import pandas as pd
+    HAVE_PANDAS = True
+except ImportError:
+    HAVE_PANDAS = False
+
+CURRENT_COLUMN = 'Current(uA)'
+CHUNK_ROWS = 1_000_000
+PROGRESS_ROWS = 10_000_000
+MAX_UNMATCHED_WARNINGS = 20
+
+# Summary columns of the JSON/CSV results, in CSV column order
+SUMMARY_FIELDS = [
+    'label', 'input', 'tx_packets', 'matched_packets', 'loss_pct',
+    'latency_min_ms', 'latency_mean_ms', 'latency_p50_ms', 'latency_p90_ms',
+    'latency_p99_ms', 'latency_max_ms', 'latency_stddev_ms',
+    'voltage_v', 'avg_current_ua', 'energy_tx_rx_uj', 'energy_interval_uj',
+]
+# Latency statistics checked by the regression comparison
+COMPARE_METRICS = ['latency_mean_ms', 'latency_p50_ms', 'latency_p90_ms', 'latency_p99_ms']
 
 class TriggerEvent:
     """Represents a trigger event with timestamp and channel"""
@@ -33,82 +62,200 @@ class LatencyMeasurement:
         self.tx_time = tx_time
         self.rx_time = rx_time
         self.latency = rx_time - tx_time
+        # Filled in by CurrentTrace.annotate() when the capture has current samples
+        self.energy_uj: Optional[float] = None
+        self.period_energy_uj: Optional[float] = None
     
     def __repr__(self):
         return f"Packet{self.packet_num}: {self.latency:.3f}ms"
 
-def detect_rising_edges(timestamps: List[float], channel_data: List[int]) -> List[float]:
+class CurrentTrace:
+    """Running charge integral of the capture, sampled at the trigger edges"""
+    def __init__(self, edge_charge_nc: Dict[float, float], voltage: float):
+        # Trapezoidal charge from the first sample up to each edge, in nC (uA * ms)
+        self.edge_charge_nc = edge_charge_nc
+        self.voltage = voltage
+
+    def charge_between(self, start: float, end: float) -> float:
+        """
+        Charge drawn between two trigger edges
+        
+        Args:
+            start: Edge timestamp in milliseconds
+            end: Later edge timestamp in milliseconds
+        
+        Returns:
+            Charge in nC
+        """
+        return self.edge_charge_nc[end] - self.edge_charge_nc[start]
+
+    def energy_between(self, start: float, end: float) -> float:
+        """Energy in uJ drawn between two trigger edges"""
+        return self.charge_between(start, end) * self.voltage / 1000.0
+
+    def average_current(self, start: float, end: float) -> float:
+        """Average current in uA between two trigger edges"""
+        if end <= start:
+            return 0.0
+        return self.charge_between(start, end) / (end - start)
+
+    def annotate(self, measurements: List[LatencyMeasurement]) -> None:
+        """
+        Add the TX to RX energy and the energy of the packet interval to each measurement
+        
+        The packet interval runs from a TX edge to the next matched TX edge, so it
+        includes the idle and power save time between packets. The last packet has
+        no interval.
+        """
+        for i, measurement in enumerate(measurements):
+            measurement.energy_uj = self.energy_between(measurement.tx_time, measurement.rx_time)
+            if i + 1 < len(measurements):
+                measurement.period_energy_uj = self.energy_between(
+                    measurement.tx_time, measurements[i + 1].tx_time)
+
+class CaptureParser:
     """
-    Detect rising edges (0 -> 1 transitions) in digital channel data
-    
-    Args:
-        timestamps: List of timestamp values in milliseconds
-        channel_data: List of digital values (0 or 1)
+    Streaming edge detector and charge integrator
     
-    Returns:
-        List of timestamps where rising edges occur
+    Samples are fed in chunks and only the rising edges of D0/D1, with the running
+    charge at each edge, are kept, so memory does not grow with the capture length.
     """
-    rising_edges = []
-    prev_value = 0
-    
-    for i, (timestamp, value) in enumerate(zip(timestamps, channel_data)):
-        if prev_value == 0 and value == 1:
-            rising_edges.append(timestamp)
-        prev_value = value
-    
-    return rising_edges
+    def __init__(self, has_current: bool):
+        self.has_current = has_current
+        self.tx_triggers: List[float] = []
+        self.rx_triggers: List[float] = []
+        self.edge_charge_nc: Dict[float, float] = {}
+        self.rows = 0
+        # State carried over from the last sample of the previous chunk
+        self.prev_d0 = 0
+        self.prev_d1 = 0
+        self.prev_time: Optional[float] = None
+        self.prev_current = 0.0
+        self.charge_nc = 0.0
+
+    def feed_row(self, timestamp: float, d0: int, d1: int, current: float) -> None:
+        """Process one sample, used by the stdlib reader"""
+        if self.has_current and self.prev_time is not None:
+            self.charge_nc += (current + self.prev_current) * (timestamp - self.prev_time) / 2
+        if d0 == 1 and self.prev_d0 == 0:
+            self.tx_triggers.append(timestamp)
+            self.edge_charge_nc[timestamp] = self.charge_nc
+        if d1 == 1 and self.prev_d1 == 0:
+            self.rx_triggers.append(timestamp)
+            self.edge_charge_nc[timestamp] = self.charge_nc
+        self.prev_d0 = d0
+        self.prev_d1 = d1
+        self.prev_time = timestamp
+        self.prev_current = current
+        self.rows += 1
+
+    def feed_arrays(self, timestamps, d0, d1, currents) -> None:
+        """Process a chunk of samples as numpy arrays, used by the pandas reader"""
+        count = len(timestamps)
+        if count == 0:
+            return
+        if self.has_current:
+            prev_time = self.prev_time if self.prev_time is not None else timestamps[0]
+            prev_current = self.prev_current if self.prev_time is not None else currents[0]
+            dt = np.diff(timestamps, prepend=prev_time)
+            di = currents + np.concatenate(([prev_current], currents[:-1]))
+            charge = self.charge_nc + np.cumsum(di * dt / 2)
+        for edges, data, prev in ((self.tx_triggers, d0, self.prev_d0),
+                                  (self.rx_triggers, d1, self.prev_d1)):
+            rising = (data == 1) & (np.concatenate(([prev], data[:-1])) == 0)
+            idx = np.flatnonzero(rising)
+            edges.extend(timestamps[idx].tolist())
+            if self.has_current:
+                self.edge_charge_nc.update(zip(timestamps[idx].tolist(), charge[idx].tolist()))
+            else:
+                self.edge_charge_nc.update((t, 0.0) for t in timestamps[idx].tolist())
+        if self.has_current:
+            self.charge_nc = float(charge[-1])
+            self.prev_current = float(currents[-1])
+        self.prev_d0 = int(d0[-1])
+        self.prev_d1 = int(d1[-1])
+        self.prev_time = float(timestamps[-1])
+        self.rows += count
+
+def read_csv_stdlib(filename: str, parser: CaptureParser, columns: List[int]) -> None:
+    """Stream the CSV row by row with the csv module"""
+    ts_col, d0_col, d1_col, current_col = columns
+    with open(filename, 'r', newline='') as csvfile:
+        reader = csv.reader(csvfile)
+        next(reader)
+        for row in reader:
+            try:
+                current = float(row[current_col]) if parser.has_current else 0.0
+                parser.feed_row(float(row[ts_col]), int(row[d0_col]), int(row[d1_col]), current)
+            except (ValueError, IndexError) as e:
+                print(f"Warning: Skipping invalid row {parser.rows}: {e}")
+                continue
+            if parser.rows % PROGRESS_ROWS == 0:
+                print(f"Processed {parser.rows} rows...")
+
+def read_csv_pandas(filename: str, parser: CaptureParser, names: List[str]) -> None:
+    """Stream the CSV in chunks with the pandas C parser and vectorized edge detection"""
+    usecols = [name for name in names if name]
+    for chunk in pd.read_csv(filename, usecols=usecols, chunksize=CHUNK_ROWS,
+                             engine='c', low_memory=True, on_bad_lines='warn'):
+        chunk = chunk.apply(pd.to_numeric, errors='coerce')
+        invalid = chunk.isna().any(axis=1)
+        if invalid.any():
+            print(f"Warning: Skipping {int(invalid.sum())} invalid rows after row {parser.rows}")
+            chunk = chunk[~invalid]
+        timestamps = chunk[names[0]].to_numpy(dtype=np.float64)
+        d0 = chunk[names[1]].to_numpy(dtype=np.int8)
+        d1 = chunk[names[2]].to_numpy(dtype=np.int8)
+        currents = chunk[names[3]].to_numpy(dtype=np.float64) if parser.has_current else None
+        before = parser.rows
+        parser.feed_arrays(timestamps, d0, d1, currents)
+        if parser.rows // PROGRESS_ROWS != before // PROGRESS_ROWS:
+            print(f"Processed {parser.rows} rows...")
 
-def parse_csv_file(filename: str) -> Tuple[List[float], List[float]]:
+def parse_csv_file(filename: str) -> CaptureParser:
     """
     Parse PPK2 CSV file and extract TX (D0) and RX (D1) trigger timestamps
     
+    The file is streamed, with pandas in chunks when it is installed and with the
+    csv module otherwise, so captures larger than memory can be analyzed.
+    
     Args:
         filename: Path to the CSV file
     
     Returns:
-        Tuple of (tx_triggers, rx_triggers) timestamp lists
+        CaptureParser holding the TX/RX trigger timestamps and, when the export has
+        a current column, the charge at each trigger
     """
-    timestamps = []
-    d0_data = []
-    d1_data = []
-    
     try:
         with open(filename, 'r', newline='') as csvfile:
-            reader = csv.DictReader(csvfile)
-            
-            # Verify required columns exist
-            fieldnames = reader.fieldnames
-            if fieldnames is None:
-                raise ValueError("CSV file has no column headers")
-            if 'Timestamp(ms)' not in fieldnames:
-                raise ValueError("CSV file must contain 'Timestamp(ms)' column")
-            if 'D0' not in fieldnames or 'D1' not in fieldnames:
-                raise ValueError("CSV file must contain 'D0' and 'D1' columns")
-            
-            print(f"Parsing CSV file: {filename}")
-            print(f"Columns found: {fieldnames}")
-            
-            row_count = 0
-            for row in reader:
-                try:
-                    timestamp = float(row['Timestamp(ms)'])
-                    d0_value = int(row['D0'])
-                    d1_value = int(row['D1'])
-                    
-                    timestamps.append(timestamp)
-                    d0_data.append(d0_value)
-                    d1_data.append(d1_value)
-                    
-                    row_count += 1
-                    if row_count % 100000 == 0:
-                        print(f"Processed {row_count} rows...")
-                        
-                except (ValueError, KeyError) as e:
-                    print(f"Warning: Skipping invalid row {row_count}: {e}")
-                    continue
-            
-            print(f"Successfully parsed {row_count} data points")
-            
+            fieldnames = next(csv.reader(csvfile), None)
+        
+        # Verify required columns exist
+        if fieldnames is None:
+            raise ValueError("CSV file has no column headers")
+        if 'Timestamp(ms)' not in fieldnames:
+            raise ValueError("CSV file must contain 'Timestamp(ms)' column")
+        if 'D0' not in fieldnames or 'D1' not in fieldnames:
+            raise ValueError("CSV file must contain 'D0' and 'D1' columns")
+        has_current = CURRENT_COLUMN in fieldnames
+        
+        print(f"Parsing CSV file: {filename}")
+        print(f"Columns found: {fieldnames}")
+        if not has_current:
+            print(f"No '{CURRENT_COLUMN}' column, energy analysis disabled")
+        
+        parser = CaptureParser(has_current)
+        if HAVE_PANDAS:
+            read_csv_pandas(filename, parser, ['Timestamp(ms)', 'D0', 'D1',
+                                               CURRENT_COLUMN if has_current else None])
+        else:
+            columns = [fieldnames.index('Timestamp(ms)'), fieldnames.index('D0'),
+                       fieldnames.index('D1'),
+                       fieldnames.index(CURRENT_COLUMN) if has_current else -1]
+            read_csv_stdlib(filename, parser, columns)
+        
+        print(f"Successfully parsed {parser.rows} data points")
+        
     except FileNotFoundError:
         print(f"Error: File '{filename}' not found")
         sys.exit(1)
@@ -116,21 +263,20 @@ def parse_csv_file(filename: str) -> Tuple[List[float], List[float]]:
         print(f"Error reading CSV file: {e}")
         sys.exit(1)
     
-    # Detect rising edges
-    print("Detecting trigger events...")
-    tx_triggers = detect_rising_edges(timestamps, d0_data)
-    rx_triggers = detect_rising_edges(timestamps, d1_data)
-    
-    print(f"Found {len(tx_triggers)} TX triggers (D0)")
-    print(f"Found {len(rx_triggers)} RX triggers (D1)")
+    print(f"Found {len(parser.tx_triggers)} TX triggers (D0)")
+    print(f"Found {len(parser.rx_triggers)} RX triggers (D1)")
     
-    return tx_triggers, rx_triggers
+    return parser
 
 def match_triggers_and_calculate_latency(tx_triggers: List[float], rx_triggers: List[float], 
                                        max_latency_ms: float = 100.0) -> List[LatencyMeasurement]:
     """
     Match TX and RX triggers and calculate latency measurements
     
+    Each TX trigger is paired with the first unused RX trigger after it. Both lists
+    are sorted, so this is a single two-pointer pass: an RX trigger is either
+    consumed by a match or skipped because it precedes the current TX trigger.
+    
     Args:
         tx_triggers: List of TX trigger timestamps
         rx_triggers: List of RX trigger timestamps  
@@ -140,51 +286,231 @@ def match_triggers_and_calculate_latency(tx_triggers: List[float], rx_triggers:
         List of LatencyMeasurement objects
     """
     measurements = []
-    used_rx_indices = set()
+    unmatched = 0
+    rx_idx = 0
     
     print("Matching TX and RX triggers...")
     
     for packet_num, tx_time in enumerate(tx_triggers):
-        best_match = None
-        best_latency = float('inf')
-        best_idx = -1
+        # RX must be after TX
+        while rx_idx < len(rx_triggers) and rx_triggers[rx_idx] <= tx_time:
+            rx_idx += 1
         
-        # Find the closest RX trigger after this TX trigger
-        for i, rx_time in enumerate(rx_triggers):
-            if i in used_rx_indices:
-                continue
-                
-            # RX must be after TX
-            if rx_time <= tx_time:
-                continue
-            
-            latency = rx_time - tx_time
-            
-            # Filter out unreasonably high latencies
-            if latency > max_latency_ms:
-                continue
-            
-            # Find the closest valid RX trigger
-            if latency < best_latency:
-                best_latency = latency
-                best_match = rx_time
-                best_idx = i
+        # Filter out unreasonably high latencies
+        if rx_idx < len(rx_triggers) and rx_triggers[rx_idx] - tx_time <= max_latency_ms:
+            measurements.append(LatencyMeasurement(packet_num, tx_time, rx_triggers[rx_idx]))
+            rx_idx += 1
+            continue
         
-        if best_match is not None:
-            measurements.append(LatencyMeasurement(packet_num, tx_time, best_match))
-            used_rx_indices.add(best_idx)
-        else:
+        unmatched += 1
+        if unmatched <= MAX_UNMATCHED_WARNINGS:
             print(f"Warning: No matching RX trigger found for TX trigger {packet_num} at {tx_time:.3f}ms")
     
+    if unmatched > MAX_UNMATCHED_WARNINGS:
+        print(f"Warning: {unmatched} TX triggers without a matching RX trigger in total")
     print(f"Successfully matched {len(measurements)} packet pairs")
     return measurements
 
-def generate_markdown_table(measurements: List[LatencyMeasurement]) -> str:
+def percentile(sorted_values: List[float], pct: float) -> float:
+    """Percentile with linear interpolation between the closest ranks"""
+    pos = (len(sorted_values) - 1) * pct / 100.0
+    lower = math.floor(pos)
+    upper = min(lower + 1, len(sorted_values) - 1)
+    return sorted_values[lower] + (sorted_values[upper] - sorted_values[lower]) * (pos - lower)
+
+def compute_summary(measurements: List[LatencyMeasurement], tx_count: int,
+                    trace: Optional[CurrentTrace], label: Optional[str],
+                    input_file: str) -> Dict[str, Any]:
+    """
+    Compute the summary statistics of a capture
+    
+    Args:
+        measurements: List of LatencyMeasurement objects, annotated when trace is set
+        tx_count: Number of TX triggers, unmatched ones count as lost
+        trace: Current samples for the energy fields, None to leave them empty
+        label: Name of the measured configuration, defaults to the input file name
+        input_file: Path of the analyzed capture
+    
+    Returns:
+        Dictionary with the SUMMARY_FIELDS keys
+    """
+    latencies = sorted(m.latency for m in measurements)
+    summary = {
+        'label': label or os.path.splitext(os.path.basename(input_file))[0],
+        'input': input_file,
+        'tx_packets': tx_count,
+        'matched_packets': len(measurements),
+        'loss_pct': 100.0 * (tx_count - len(measurements)) / tx_count,
+        'latency_min_ms': latencies[0],
+        'latency_mean_ms': statistics.fmean(latencies),
+        'latency_p50_ms': percentile(latencies, 50),
+        'latency_p90_ms': percentile(latencies, 90),
+        'latency_p99_ms': percentile(latencies, 99),
+        'latency_max_ms': latencies[-1],
+        'latency_stddev_ms': statistics.stdev(latencies) if len(latencies) > 1 else 0.0,
+        'voltage_v': None,
+        'avg_current_ua': None,
+        'energy_tx_rx_uj': None,
+        'energy_interval_uj': None,
+    }
+    
+    if trace is not None:
+        periods = [m.period_energy_uj for m in measurements if m.period_energy_uj is not None]
+        start = measurements[0].tx_time
+        end = measurements[-1].rx_time
+        summary['voltage_v'] = trace.voltage
+        summary['avg_current_ua'] = trace.average_current(start, end)
+        summary['energy_tx_rx_uj'] = statistics.fmean(m.energy_uj for m in measurements)
+        summary['energy_interval_uj'] = statistics.fmean(periods) if periods else None
+    
+    return summary
+
+def write_summary_json(filename: str, summary: Dict[str, Any]) -> None:
+    """Write the summary of this capture as a JSON object"""
+    with open(filename, 'w') as f:
+        json.dump(summary, f, indent=2)
+        f.write('\n')
+
+def write_summary_csv(filename: str, summary: Dict[str, Any]) -> None:
+    """
+    Append the summary of this capture as a CSV row
+    
+    The header is written when the file is new, so one file can collect the
+    results of a whole overlay matrix.
+    """
+    new_file = not os.path.exists(filename) or os.path.getsize(filename) == 0
+    with open(filename, 'a', newline='') as f:
+        writer = csv.DictWriter(f, fieldnames=SUMMARY_FIELDS)
+        if new_file:
+            writer.writeheader()
+        writer.writerow({key: '' if value is None else value for key, value in summary.items()})
+
+def load_results(filename: str) -> Dict[str, Dict[str, Any]]:
+    """
+    Load summaries written by --json or --csv, keyed by label
+    
+    A JSON file may hold one summary object or a list of them; a CSV file holds
+    one summary per row. Later entries with the same label replace earlier ones.
+    """
+    if filename.lower().endswith('.json'):
+        with open(filename, 'r') as f:
+            data = json.load(f)
+        rows = data if isinstance(data, list) else [data]
+    else:
+        with open(filename, 'r', newline='') as f:
+            rows = list(csv.DictReader(f))
+    
+    results = {}
+    for row in rows:
+        results[row['label']] = row
+    return results
+
+def to_float(value: Any) -> Optional[float]:
+    """Convert a JSON/CSV field to float, None when it is empty"""
+    if value is None or value == '':
+        return None
+    return float(value)
+
+def compare_results(baseline_file: str, candidate_file: str, threshold_pct: float,
+                    threshold_ms: float, loss_threshold: float) -> int:
+    """
+    Compare two result files and print a markdown table of the differences
+    
+    A latency statistic regresses when the candidate exceeds the baseline by
+    more than threshold_pct percent and by more than threshold_ms, so sub-sample
+    jitter on fast configurations is not flagged. Loss regresses when it grows by
+    more than loss_threshold percentage points. A configuration missing from the
+    candidate counts as a regression.
+    
+    Returns:
+        Number of regressions
+    """
+    baseline = load_results(baseline_file)
+    candidate = load_results(candidate_file)
+    regressions = 0
+    
+    table = "## Latency Regression Check\n\n"
+    table += f"Baseline: {baseline_file}, candidate: {candidate_file}, "
+    table += f"threshold: +{threshold_pct:g}% and +{threshold_ms:g} ms, loss +{loss_threshold:g} pp\n\n"
+    table += "| Configuration | Metric | Baseline | Candidate | Change | Status |\n"
+    table += "|---------------|--------|----------|-----------|--------|--------|\n"
+    
+    for label, base in baseline.items():
+        cand = candidate.get(label)
+        if cand is None:
+            table += f"| {label} | - | - | - | - | **MISSING** |\n"
+            regressions += 1
+            continue
+        
+        for metric in COMPARE_METRICS + ['loss_pct']:
+            base_value = to_float(base.get(metric))
+            cand_value = to_float(cand.get(metric))
+            if base_value is None or cand_value is None:
+                continue
+            delta = cand_value - base_value
+            if metric == 'loss_pct':
+                regressed = delta > loss_threshold
+                change = f"{delta:+.2f} pp"
+            else:
+                limit = max(base_value * threshold_pct / 100.0, threshold_ms)
+                regressed = delta > limit
+                change = f"{delta:+.3f} ms"
+                if base_value > 0:
+                    change += f" ({100.0 * delta / base_value:+.1f}%)"
+            status = "**REGRESSION**" if regressed else "ok"
+            regressions += regressed
+            table += f"| {label} | {metric} | {base_value:.3f} | {cand_value:.3f} | {change} | {status} |\n"
+    
+    for label in candidate:
+        if label not in baseline:
+            table += f"| {label} | - | - | - | - | new |\n"
+    
+    table += f"\n**{regressions} regression(s)**\n"
+    print(table)
+    return regressions
+
+def generate_energy_summary(measurements: List[LatencyMeasurement], trace: CurrentTrace,
+                            label: Optional[str]) -> str:
+    """
+    Generate the energy part of the summary statistics
+    
+    Args:
+        measurements: List of annotated LatencyMeasurement objects
+        trace: Current samples of the capture
+        label: Name of the measured configuration
+    
+    Returns:
+        Markdown formatted list string
+    """
+    energies = [m.energy_uj for m in measurements]
+    periods = [m.period_energy_uj for m in measurements if m.period_energy_uj is not None]
+    # Transmission window: first TX edge to the last matched RX edge
+    start = measurements[0].tx_time
+    end = measurements[-1].rx_time
+    
+    summary = f"**Energy ({label or 'this capture'}, {trace.voltage:.2f} V):**\n"
+    summary += f"- Average Current (TX window): {trace.average_current(start, end):.1f} uA\n"
+    summary += f"- Total Energy (TX window): {trace.energy_between(start, end):.1f} uJ\n"
+    summary += f"- Average Energy TX to RX: {sum(energies) / len(energies):.2f} uJ/packet\n"
+    if periods:
+        summary += f"- Average Energy per Packet Interval: {sum(periods) / len(periods):.2f} uJ/packet\n"
+    summary += "\n"
+    return summary
+
+def generate_markdown_table(measurements: List[LatencyMeasurement],
+                            trace: Optional[CurrentTrace] = None,
+                            label: Optional[str] = None,
+                            summary: Optional[Dict[str, Any]] = None,
+                            per_packet: bool = True) -> str:
     """
     Generate markdown table from latency measurements
     
     Args:
         measurements: List of LatencyMeasurement objects
+        trace: Current samples for the energy columns, None for latency only
+        label: Name of the measured configuration
+        summary: Result of compute_summary() for the percentile and loss lines
+        per_packet: Include one table row per packet
     
     Returns:
         Markdown formatted table string
@@ -204,20 +530,48 @@ def generate_markdown_table(measurements: List[LatencyMeasurement]) -> str:
     table += f"- Total Packets: {len(measurements)}\n"
     table += f"- Average Latency: {avg_latency:.3f} ms\n"
     table += f"- Minimum Latency: {min_latency:.3f} ms\n"
-    table += f"- Maximum Latency: {max_latency:.3f} ms\n\n"
+    table += f"- Maximum Latency: {max_latency:.3f} ms\n"
+    if summary is not None:
+        table += f"- Latency p50 / p90 / p99: {summary['latency_p50_ms']:.3f} / "
+        table += f"{summary['latency_p90_ms']:.3f} / {summary['latency_p99_ms']:.3f} ms\n"
+        table += f"- Latency Std Deviation: {summary['latency_stddev_ms']:.3f} ms\n"
+        table += f"- Loss: {summary['tx_packets'] - summary['matched_packets']} of "
+        table += f"{summary['tx_packets']} TX triggers unmatched ({summary['loss_pct']:.2f}%)\n"
+    table += "\n"
+    
+    if trace is not None:
+        table += generate_energy_summary(measurements, trace, label)
+    
+    if not per_packet:
+        return table
+    
+    if trace is None:
+        table += "| Packet Number | TX Trigger Time (ms) | RX Trigger Time (ms) | Latency (ms) |\n"
+        table += "|---------------|---------------------|---------------------|-------------|\n"
+        
+        # Add data rows
+        for measurement in measurements:
+            table += f"| {measurement.packet_num} | {measurement.tx_time:.2f} | {measurement.rx_time:.2f} | {measurement.latency:.2f} |\n"
+        
+        # Add summary rows
+        table += "|---------------|---------------------|---------------------|-------------|\n"
+        table += f"| **Average** | - | - | **{avg_latency:.2f}** |\n"
+        table += f"| **Minimum** | - | - | **{min_latency:.2f}** |\n"
+        table += f"| **Maximum** | - | - | **{max_latency:.2f}** |\n"
+        return table
     
-    table += "| Packet Number | TX Trigger Time (ms) | RX Trigger Time (ms) | Latency (ms) |\n"
-    table += "|---------------|---------------------|---------------------|-------------|\n"
+    table += "| Packet Number | TX Trigger Time (ms) | RX Trigger Time (ms) | Latency (ms) | TX-RX Energy (uJ) | Interval Energy (uJ) |\n"
+    table += "|---------------|---------------------|---------------------|-------------|------------------|---------------------|\n"
     
-    # Add data rows
     for measurement in measurements:
-        table += f"| {measurement.packet_num} | {measurement.tx_time:.2f} | {measurement.rx_time:.2f} | {measurement.latency:.2f} |\n"
+        period = f"{measurement.period_energy_uj:.2f}" if measurement.period_energy_uj is not None else "-"
+        table += f"| {measurement.packet_num} | {measurement.tx_time:.2f} | {measurement.rx_time:.2f} | {measurement.latency:.2f} | {measurement.energy_uj:.2f} | {period} |\n"
     
-    # Add summary rows
-    table += "|---------------|---------------------|---------------------|-------------|\n"
-    table += f"| **Average** | - | - | **{avg_latency:.2f}** |\n"
-    table += f"| **Minimum** | - | - | **{min_latency:.2f}** |\n"
-    table += f"| **Maximum** | - | - | **{max_latency:.2f}** |\n"
+    energies = [m.energy_uj for m in measurements]
+    table += "|---------------|---------------------|---------------------|-------------|------------------|---------------------|\n"
+    table += f"| **Average** | - | - | **{avg_latency:.2f}** | **{sum(energies) / len(energies):.2f}** | - |\n"
+    table += f"| **Minimum** | - | - | **{min_latency:.2f}** | **{min(energies):.2f}** | - |\n"
+    table += f"| **Maximum** | - | - | **{max_latency:.2f}** | **{max(energies):.2f}** | - |\n"
     
     return table
 
@@ -230,18 +584,21 @@ def main():
 Examples:
     python ppk_record_analysis.py -i udp_softap.csv
     python ppk_record_analysis.py -i my_recording.csv -m 50.0
+    python ppk_record_analysis.py -i sta_twt.csv -v 3.6 -l "TWT 500 ms"
+    python ppk_record_analysis.py -i softap.csv -l softap --summary-only --json softap.json --csv matrix.csv
+    python ppk_record_analysis.py --compare baseline.csv candidate.csv --threshold-pct 5
 
 The script expects CSV format with columns:
-    Timestamp(ms), D0, D1, D2, D3, D4, D5, D6, D7
+    Timestamp(ms), Current(uA), D0, D1, D2, D3, D4, D5, D6, D7
     
 Where:
     - D0: TX trigger channel (0 -> 1 transition indicates packet transmission)
     - D1: RX trigger channel (0 -> 1 transition indicates packet reception)
+    - Current(uA): optional, current of the DK powered by the PPK2
         """
     )
     
     parser.add_argument('-i', '--input', 
-                       required=True,
                        help='Input CSV file path (PPK2 recording)')
     
     parser.add_argument('-m', '--max-latency',
@@ -252,10 +609,63 @@ Where:
     parser.add_argument('-o', '--output',
                        help='Output file for markdown table (default: stdout)')
     
+    parser.add_argument('-v', '--voltage',
+                       type=float,
+                       default=3.3,
+                       help='PPK2 supply voltage in V for the energy figures (default: 3.3)')
+    
+    parser.add_argument('-l', '--label',
+                       help='Name of the measured configuration, used as key by --compare '
+                            '(default: input file name)')
+    
+    parser.add_argument('--summary-only',
+                       action='store_true',
+                       help='Leave the per-packet rows out of the markdown output')
+    
+    parser.add_argument('--json',
+                       help='Write the summary statistics to this JSON file')
+    
+    parser.add_argument('--csv',
+                       help='Append the summary statistics as a row to this CSV file')
+    
+    parser.add_argument('--compare',
+                       nargs=2,
+                       metavar=('BASELINE', 'CANDIDATE'),
+                       help='Compare two --json/--csv result files instead of analyzing a capture, '
+                            'exit with 1 on a regression')
+    
+    parser.add_argument('--threshold-pct',
+                       type=float,
+                       default=10.0,
+                       help='Relative latency increase flagged by --compare (default: 10.0)')
+    
+    parser.add_argument('--threshold-ms',
+                       type=float,
+                       default=0.1,
+                       help='Minimum absolute latency increase flagged by --compare (default: 0.1)')
+    
+    parser.add_argument('--loss-threshold',
+                       type=float,
+                       default=1.0,
+                       help='Loss increase in percentage points flagged by --compare (default: 1.0)')
+    
     args = parser.parse_args()
     
+    if args.compare:
+        try:
+            regressions = compare_results(args.compare[0], args.compare[1], args.threshold_pct,
+                                          args.threshold_ms, args.loss_threshold)
+        except (OSError, ValueError, KeyError) as e:
+            print(f"Error reading result files: {e}")
+            sys.exit(1)
+        sys.exit(1 if regressions else 0)
+    
+    if not args.input:
+        parser.error("either -i/--input or --compare is required")
+    
     # Parse CSV file and detect triggers
-    tx_triggers, rx_triggers = parse_csv_file(args.input)
+    capture = parse_csv_file(args.input)
+    tx_triggers, rx_triggers = capture.tx_triggers, capture.rx_triggers
     
     if not tx_triggers:
         print("Error: No TX triggers found in the data")
@@ -272,8 +682,29 @@ Where:
         print("Error: No valid latency measurements could be calculated")
         sys.exit(1)
     
+    # Integrate the current over each packet when the capture has it
+    trace = None
+    if capture.has_current:
+        trace = CurrentTrace(capture.edge_charge_nc, args.voltage)
+        trace.annotate(measurements)
+    
+    summary = compute_summary(measurements, len(tx_triggers), trace, args.label, args.input)
+    
+    # Machine-readable summary for dashboards and --compare
+    try:
+        if args.json:
+            write_summary_json(args.json, summary)
+            print(f"Summary saved to: {args.json}")
+        if args.csv:
+            write_summary_csv(args.csv, summary)
+            print(f"Summary appended to: {args.csv}")
+    except OSError as e:
+        print(f"Error writing summary file: {e}")
+        sys.exit(1)
+    
     # Generate markdown table
-    markdown_table = generate_markdown_table(measurements)
+    markdown_table = generate_markdown_table(measurements, trace, args.label, summary,
+                                             not args.summary_only)
     
     # Output results
     if args.output:
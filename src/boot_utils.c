@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+
+#include "boot_utils.h"
+
+LOG_MODULE_REGISTER(boot_utils, CONFIG_LOG_DEFAULT_LEVEL);
+
+static const char *const boot_phase_names[BOOT_PHASE_COUNT] = {
+	"main", "supplicant ready", "iface up", "softap enabled", "wifi connected",
+	"ipv4 ready", "station connected", "first packet",
+};
+
+/* Phases are marked once from several threads; the bits make the first mark win */
+static ATOMIC_DEFINE(boot_marked, BOOT_PHASE_COUNT);
+static uint64_t boot_cycles[BOOT_PHASE_COUNT];
+/* Start of the profile, 0 = kernel start */
+static uint64_t boot_origin_cycles;
+static uint32_t boot_reconnects;
+
+static uint32_t boot_ms(uint64_t cycles)
+{
+	return (uint32_t)k_cyc_to_ms_floor64(cycles);
+}
+
+static void boot_report(void)
+{
+	uint64_t prev = boot_origin_cycles;
+
+	if (boot_reconnects) {
+		LOG_INF("Reconnect %u to first packet:", boot_reconnects);
+	} else {
+		LOG_INF("Boot to first packet:");
+	}
+
+	for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+		if (!atomic_test_bit(boot_marked, i) || boot_cycles[i] < boot_origin_cycles) {
+			continue;
+		}
+		LOG_INF("  %-18s %6u ms (+%u ms)", boot_phase_names[i],
+			boot_ms(boot_cycles[i] - boot_origin_cycles),
+			boot_ms(boot_cycles[i] > prev ? boot_cycles[i] - prev : 0));
+		prev = MAX(prev, boot_cycles[i]);
+	}
+}
+
+void boot_mark(enum boot_phase phase)
+{
+	if (atomic_test_bit(boot_marked, phase) || atomic_test_and_set_bit(boot_marked, phase)) {
+		return;
+	}
+
+	boot_cycles[phase] = k_cycle_get_64();
+	if (phase == BOOT_PHASE_FIRST_PACKET) {
+		boot_report();
+	}
+}
+
+void boot_restart(void)
+{
+	boot_origin_cycles = k_cycle_get_64();
+	boot_reconnects++;
+	for (int i = BOOT_PHASE_WIFI_CONNECTED; i < BOOT_PHASE_COUNT; i++) {
+		/* SoftAP phases don't repeat on a station reconnect */
+		if (i != BOOT_PHASE_STATION_CONNECTED) {
+			atomic_clear_bit(boot_marked, i);
+		}
+	}
+}
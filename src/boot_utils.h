@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef BOOT_UTILS_H
+#define BOOT_UTILS_H
+
+#include <zephyr/kernel.h>
+
+/* Bring-up phases in the order they normally complete */
+enum boot_phase {
+	BOOT_PHASE_MAIN,              /* main() entered */
+	BOOT_PHASE_SUPPLICANT_READY,  /* WPA supplicant ready */
+	BOOT_PHASE_IFACE_UP,          /* Wi-Fi interface up */
+	BOOT_PHASE_SOFTAP_ENABLED,    /* SoftAP beaconing */
+	BOOT_PHASE_WIFI_CONNECTED,    /* Associated with the AP */
+	BOOT_PHASE_IPV4_READY,        /* DHCP bound or static address usable */
+	BOOT_PHASE_STATION_CONNECTED, /* First station joined the SoftAP */
+	BOOT_PHASE_FIRST_PACKET,      /* First test packet sent or received */
+	BOOT_PHASE_COUNT,
+};
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_BOOT_PROFILE)
+/**
+ * @brief Timestamp a bring-up phase
+ *
+ * Only the first mark of a phase per profile counts, so hot paths may call
+ * this for every packet. Marking BOOT_PHASE_FIRST_PACKET logs the breakdown.
+ *
+ * @param phase Phase that just completed
+ */
+void boot_mark(enum boot_phase phase);
+
+/**
+ * @brief Start a reconnect profile
+ *
+ * Clears the phases from BOOT_PHASE_WIFI_CONNECTED on and measures them from
+ * now, e.g. after the link was lost.
+ */
+void boot_restart(void);
+#else
+static inline void boot_mark(enum boot_phase phase)
+{
+}
+
+static inline void boot_restart(void)
+{
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_BOOT_PROFILE */
+
+#endif /* BOOT_UTILS_H */
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+
+#include "boot_utils.h"
+#include "engine_utils.h"
+#include "led_utils.h"
+#include "load_utils.h"
+#include "pool_utils.h"
+#include "ps_utils.h"
+#include "raw_utils.h"
+#include "stats_utils.h"
+#include "trace_utils.h"
+#include "udp_utils.h"
+
+LOG_MODULE_REGISTER(engine_utils, CONFIG_LOG_DEFAULT_LEVEL);
+
+BUILD_ASSERT(ENGINE_MAX_TRANSPORTS >= UDP_AC_COUNT + 1, "Not enough transport slots");
+
+/* Transports of the image in send order, UDP streams first */
+static int engine_transports_get(struct latency_transport **transports)
+{
+	int count = 0;
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRANSPORT_UDP)
+	count += udp_transports_get(transports, ENGINE_MAX_TRANSPORTS);
+#endif
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRANSPORT_RAW)
+	if (count < ENGINE_MAX_TRANSPORTS) {
+		transports[count++] = raw_transport_get();
+	}
+#endif
+	return count;
+}
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX)
+static struct tx_pacer engine_pacer;
+static atomic_t engine_open;
+static atomic_t engine_stop_req;
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TX_STAGES)
+/* One breakdown per transport, interleaved paths must not share histograms */
+static struct latency_stage_stats engine_stage_stats[ENGINE_MAX_TRANSPORTS];
+static char engine_stage_names[ENGINE_MAX_TRANSPORTS][24];
+#endif
+
+/* Start a session's TX stage breakdown */
+static void engine_stage_begin(const struct engine_session *session)
+{
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TX_STAGES)
+	for (int i = 0; i < session->count; i++) {
+		snprintk(engine_stage_names[i], sizeof(engine_stage_names[i]), "tx-stages/%s",
+			 session->transports[i]->name);
+		latency_stage_init(&engine_stage_stats[i], engine_stage_names[i]);
+	}
+#endif
+}
+
+/* Account one sent packet; prep_cycles to send_cycles is the build, then the socket call */
+static void engine_stage_record(int idx, const struct latency_transport *transport, uint32_t seq,
+				const struct engine_sent *sent)
+{
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TX_STAGES)
+	latency_stage_update(&engine_stage_stats[idx], sent->prep_cycles, sent->send_cycles,
+			     sent->sent_cycles);
+	trace_utils_record(TRACE_EVT_TX_SENT, transport->trace_stream, seq, sent->sent_cycles, 0,
+			   sent->len);
+#endif
+}
+
+static void engine_stage_print(const struct engine_session *session)
+{
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TX_STAGES)
+	for (int i = 0; i < session->count; i++) {
+		latency_stage_print(&engine_stage_stats[i]);
+	}
+#endif
+}
+
+/* Per-step summary of the throughput benchmark, the receiver reports the rest */
+static void engine_step_print(const struct tx_step *step, uint32_t sent, uint32_t errors,
+			      int64_t elapsed_ms)
+{
+	if (!IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_THROUGHPUT)) {
+		return;
+	}
+
+	LOG_INF("Step %u: interval %u us, sent %u (%u errors) in %lld ms, %lld pps", step->tag,
+		step->interval_us, sent, errors, elapsed_ms,
+		elapsed_ms > 0 ? (int64_t)sent * MSEC_PER_SEC / elapsed_ms : 0);
+}
+
+static void engine_burst_record(struct engine_session *session, uint64_t start_cycles)
+{
+	uint32_t us = (uint32_t)k_cyc_to_us_floor64(k_cycle_get_64() - start_cycles);
+
+	session->burst_count++;
+	session->burst_sum_us += us;
+	session->burst_max_us = MAX(session->burst_max_us, us);
+}
+
+static void engine_session_cleanup(struct engine_session *session, int count)
+{
+	for (int i = count - 1; i >= 0; i--) {
+		struct latency_transport *transport = session->transports[i];
+
+		if (transport->api->cleanup) {
+			transport->api->cleanup(transport);
+		}
+	}
+}
+
+int engine_session_open(struct engine_session *session)
+{
+	int ret;
+
+	*session = (struct engine_session){0};
+	session->count = engine_transports_get(session->transports);
+	if (session->count == 0) {
+		return -ENODEV;
+	}
+
+	ps_print_config();
+	pool_monitor_start();
+	engine_stage_begin(session);
+
+	/* A stop request during transport init must not hit an uninitialized pacer */
+	tx_pacer_init(&engine_pacer, 0, TX_PACING_FIXED, 0);
+	atomic_set(&engine_stop_req, 0);
+	atomic_set(&engine_open, 1);
+
+	/* Parameters stay fixed for the whole session */
+	params_get(&session->params);
+
+	for (int i = 0; i < session->count; i++) {
+		struct latency_transport *transport = session->transports[i];
+
+		ret = transport->api->init(transport, &session->params);
+		if (ret < 0) {
+			LOG_ERR("Failed to initialize %s transport: %d", transport->name, ret);
+			engine_session_cleanup(session, i);
+			atomic_set(&engine_open, 0);
+			return ret;
+		}
+	}
+	if (session->count > 1) {
+		LOG_INF("Interleaving %d transports per deadline", session->count);
+	}
+
+	/* Cross traffic shares the TX queues with the probes for the whole session */
+	ret = load_start(session->params.target_ip, udp_tx_station_id());
+	if (ret < 0) {
+		LOG_ERR("Failed to start bulk load: %d", ret);
+		engine_session_cleanup(session, session->count);
+		atomic_set(&engine_open, 0);
+		return ret;
+	}
+
+	return 0;
+}
+
+/* Send one burst back-to-back on a transport, returns 0 or the first send error */
+static int engine_burst(struct engine_session *session, int idx, uint8_t burst_len, uint16_t tag)
+{
+	struct latency_transport *transport = session->transports[idx];
+	struct engine_pkt pkt = {
+		.burst_len = burst_len,
+		.tag = tag,
+	};
+	struct engine_sent sent;
+	int ret;
+
+	for (uint8_t i = 0; i < burst_len; i++) {
+		pkt.seq = session->seq[idx];
+		pkt.burst_idx = i;
+		sent = (struct engine_sent){0};
+
+		ret = transport->api->send(transport, &pkt, &sent);
+		if (ret < 0) {
+			trace_utils_record(TRACE_EVT_TX_ERR, transport->trace_stream, pkt.seq,
+					   k_cycle_get_64(), 0, -ret);
+			/* Expected once the open-loop benchmark saturates the stack */
+			if (transport->stop_on_error ||
+			    !IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_THROUGHPUT)) {
+				LOG_ERR("Failed to send %s packet: %d", transport->name, ret);
+			}
+			return ret;
+		}
+		engine_stage_record(idx, transport, pkt.seq, &sent);
+		boot_mark(BOOT_PHASE_FIRST_PACKET);
+
+		if (IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRACE)) {
+			trace_utils_record(TRACE_EVT_TX, transport->trace_stream, pkt.seq,
+					   sent.tx_cycles, 0, sent.len);
+		} else if (!IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_THROUGHPUT)) {
+			LOG_INF("Sent: %s packet %u at %lld ms", transport->name, pkt.seq,
+				k_uptime_get());
+		}
+		session->seq[idx]++;
+		session->sent++;
+	}
+
+	return 0;
+}
+
+int engine_run_step(struct engine_session *session, const struct tx_step *step,
+		    uint8_t burst_len)
+{
+	uint32_t step_first = session->sent;
+	uint32_t errors = 0;
+	int64_t start_time;
+	int ret = 0;
+
+	tx_pacer_init(&engine_pacer, step->interval_us, TX_PACER_DEFAULT_MODE,
+		      TX_PACER_DEFAULT_JITTER_PCT);
+	start_time = k_uptime_get();
+
+	/* Main transmission loop */
+	while ((k_uptime_get() - start_time) < step->duration_ms && !engine_stopping()) {
+		uint64_t burst_start = k_cycle_get_64();
+
+		/* Trigger LED before transmission */
+		led_trigger_tx();
+		for (int i = 0; i < session->count; i++) {
+			int idx = (session->round + i) % session->count;
+			int err = engine_burst(session, idx, burst_len, step->tag);
+
+			if (err < 0) {
+				errors++;
+				if (session->transports[idx]->stop_on_error) {
+					ret = err;
+					break;
+				}
+			}
+		}
+		session->round++;
+		if (ret < 0) {
+			break; /* Exit loop on error */
+		}
+		engine_burst_record(session, burst_start);
+
+		/* Wait for the next deadline, returns early on stop request */
+		if (tx_pacer_wait(&engine_pacer)) {
+			break;
+		}
+	}
+
+	engine_step_print(step, session->sent - step_first, errors, k_uptime_get() - start_time);
+	if (engine_pacer.overruns) {
+		LOG_WRN("TX schedule overran %u times", engine_pacer.overruns);
+	}
+	return ret;
+}
+
+int engine_session_run(struct engine_session *session)
+{
+	struct tx_step step;
+	uint32_t step_idx = 0;
+	int ret;
+
+	while (!engine_stopping() && tx_pacer_get_step(step_idx++, &session->params, &step) == 0) {
+		ret = engine_run_step(session, &step, session->params.burst_len);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+void engine_session_close(struct engine_session *session)
+{
+	load_stop();
+
+	if (engine_stopping()) {
+		LOG_INF("TX session stopped by button. Sent %u packets", session->sent);
+	} else {
+		LOG_INF("TX session completed. Sent %u packets", session->sent);
+	}
+	for (int i = 0; session->count > 1 && i < session->count; i++) {
+		LOG_INF("  %s: %u packets", session->transports[i]->name, session->seq[i]);
+	}
+	if (session->params.burst_len > 1 && session->burst_count) {
+		LOG_INF("Bursts of %u: %u sent, injection time avg %llu us max %u us",
+			session->params.burst_len, session->burst_count,
+			session->burst_sum_us / session->burst_count, session->burst_max_us);
+	}
+	engine_stage_print(session);
+	pool_monitor_stop();
+	pool_monitor_print();
+
+	engine_session_cleanup(session, session->count);
+	atomic_set(&engine_stop_req, 0);
+	atomic_set(&engine_open, 0);
+}
+
+void engine_stop(void)
+{
+	if (!atomic_get(&engine_open)) {
+		return;
+	}
+
+	atomic_set(&engine_stop_req, 1);
+	tx_pacer_cancel(&engine_pacer);
+}
+
+bool engine_stopping(void)
+{
+	return atomic_get(&engine_stop_req);
+}
+
+bool engine_running(void)
+{
+	return atomic_get(&engine_open);
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX */
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_RX)
+int engine_rx_start(void)
+{
+	struct latency_transport *transports[ENGINE_MAX_TRANSPORTS];
+	int count = engine_transports_get(transports);
+	int ret;
+
+	/* An RX device samples the pools for as long as it receives */
+	pool_monitor_start();
+	for (int i = 0; i < count; i++) {
+		ret = transports[i]->api->recv(transports[i]);
+		if (ret < 0) {
+			LOG_ERR("Failed to start %s reception: %d", transports[i]->name, ret);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_RX */
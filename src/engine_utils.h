@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef ENGINE_UTILS_H
+#define ENGINE_UTILS_H
+
+#include <zephyr/kernel.h>
+
+#include "pacing_utils.h"
+#include "params_utils.h"
+
+/* One raw transport plus one UDP transport per WMM access category */
+#define ENGINE_MAX_TRANSPORTS 5
+
+/* Probe handed to a transport's send() */
+struct engine_pkt {
+	uint32_t seq; /* Sequence number in the transport's own space */
+	uint8_t burst_idx;
+	uint8_t burst_len;
+	uint16_t tag;
+};
+
+/* Timestamps of one sent probe, k_cycle_get_64() base */
+struct engine_sent {
+	uint64_t tx_cycles;   /* TX timestamp embedded in the probe */
+	uint64_t prep_cycles; /* Probe build started, at or before tx_cycles */
+	uint64_t send_cycles; /* Right before the socket call */
+	uint64_t sent_cycles; /* Right after the socket call returned */
+	uint16_t len;         /* Bytes handed to the socket, 0 if not known */
+};
+
+struct latency_transport;
+
+/* Operations a transport implements, unused ones may be NULL */
+struct latency_transport_api {
+	/* Open the transport for a TX session with the session parameters */
+	int (*init)(struct latency_transport *transport, const struct test_params *params);
+	/* Send one probe and fill its timestamps */
+	int (*send)(struct latency_transport *transport, const struct engine_pkt *pkt,
+		    struct engine_sent *sent);
+	/* Start the RX path, returns once it runs in its own threads */
+	int (*recv)(struct latency_transport *transport);
+	/* Close what init() opened */
+	void (*cleanup)(struct latency_transport *transport);
+};
+
+struct latency_transport {
+	const struct latency_transport_api *api;
+	const char *name;
+	/* A send error ends the session instead of counting as a lost probe */
+	bool stop_on_error;
+	/* TRACE_STREAM_* of the transport's trace records */
+	uint8_t trace_stream;
+	void *ctx;
+};
+
+/* TX session over all transports of the image */
+struct engine_session {
+	struct latency_transport *transports[ENGINE_MAX_TRANSPORTS];
+	uint32_t seq[ENGINE_MAX_TRANSPORTS];
+	int count;
+	struct test_params params;
+	uint32_t sent;
+	/* Deadlines so far, rotates the transport that sends first */
+	uint32_t round;
+	/* Time taken to hand each deadline's bursts to the stack */
+	uint32_t burst_count;
+	uint64_t burst_sum_us;
+	uint32_t burst_max_us;
+};
+
+/**
+ * @brief Open a TX session on every transport of the image
+ *
+ * Reads the runtime parameters, initializes the transports in order and
+ * starts the background load, pool monitor and TX stage breakdown.
+ *
+ * @param session Session to open
+ * @return 0 on success, negative error code on failure
+ */
+int engine_session_open(struct engine_session *session);
+
+/**
+ * @brief Run one paced step of an open session
+ *
+ * Every deadline sends a burst on each transport, starting with a different
+ * transport each time so none always leads the queue.
+ *
+ * @param session Open session
+ * @param step Interval, duration and tag of the step
+ * @param burst_len Probes per transport and deadline
+ * @return 0 on success or stop request, negative error code of a
+ *         stop_on_error transport that failed
+ */
+int engine_run_step(struct engine_session *session, const struct tx_step *step,
+		    uint8_t burst_len);
+
+/**
+ * @brief Run the steps of the session parameters
+ *
+ * One step for the latency test, several for the stepped throughput
+ * benchmark.
+ *
+ * @param session Open session
+ * @return 0 on success or stop request, negative error code on failure
+ */
+int engine_session_run(struct engine_session *session);
+
+/**
+ * @brief Log the session summary and close every transport
+ *
+ * @param session Open session
+ */
+void engine_session_close(struct engine_session *session);
+
+/**
+ * @brief Ask the running session to stop
+ *
+ * Cancels the pending pacing wait, the session ends at its next check.
+ */
+void engine_stop(void);
+
+/**
+ * @brief Check whether a stop was requested for the current session
+ *
+ * @return true if the session should end
+ */
+bool engine_stopping(void);
+
+/**
+ * @brief Check whether a TX session is open
+ *
+ * @return true between engine_session_open() and engine_session_close()
+ */
+bool engine_running(void);
+
+/**
+ * @brief Start the RX path of every transport of the image
+ *
+ * Call once the interface is ready for reception.
+ *
+ * @return 0 on success, negative error code on failure
+ */
+int engine_rx_start(void);
+
+#endif /* ENGINE_UTILS_H */
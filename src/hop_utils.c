@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hop_utils.h"
+
+LOG_MODULE_REGISTER(hop_utils, CONFIG_LOG_DEFAULT_LEVEL);
+
+/* Distinct channels with a result row, further channels are only logged */
+#define HOP_MAX_CHANNELS 16
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_CHANNEL_HOP)
+int hop_get_channel(uint32_t idx, uint8_t *channel)
+{
+	const char *p = CONFIG_WIFI_LATENCY_TEST_CHANNEL_HOP_LIST;
+	uint32_t count = 0;
+	uint8_t channels[HOP_MAX_CHANNELS];
+
+	while (*p && count < ARRAY_SIZE(channels)) {
+		char *end;
+		unsigned long value = strtoul(p, &end, 10);
+
+		if (end == p || value < 1 || value > HOP_TAG_CHANNEL_MASK) {
+			LOG_ERR("Invalid channel hop list \"%s\"",
+				CONFIG_WIFI_LATENCY_TEST_CHANNEL_HOP_LIST);
+			return -EINVAL;
+		}
+		channels[count++] = value;
+
+		p = end;
+		while (*p == ',' || *p == ' ') {
+			p++;
+		}
+	}
+
+	if (count == 0) {
+		return -EINVAL;
+	}
+	if (idx >= count * CONFIG_WIFI_LATENCY_TEST_CHANNEL_HOP_ROUNDS) {
+		return -ENOENT;
+	}
+
+	*channel = channels[idx % count];
+	return 0;
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_CHANNEL_HOP */
+
+/* Dwells on one channel, merged over the rounds of the schedule */
+struct hop_channel_result {
+	uint8_t channel;
+	uint32_t dwells;
+	uint32_t received;
+	uint32_t lost;
+	uint32_t p50_us; /* Worst dwell */
+	uint32_t p99_us; /* Worst dwell */
+	uint32_t max_us;
+	bool absolute;
+};
+
+struct hop_cost {
+	uint32_t count;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint64_t sum_us;
+};
+
+static struct {
+	struct hop_channel_result channels[HOP_MAX_CHANNELS];
+	uint32_t num_channels;
+	struct hop_cost switches;
+	struct hop_cost gaps;
+
+	/* Receive gap in progress */
+	bool gap_open;
+	uint8_t gap_channel;
+	int64_t gap_start_us;
+} hop_result;
+
+static void hop_cost_record(struct hop_cost *cost, uint32_t value_us)
+{
+	if (cost->count == 0 || value_us < cost->min_us) {
+		cost->min_us = value_us;
+	}
+	cost->max_us = MAX(cost->max_us, value_us);
+	cost->sum_us += value_us;
+	cost->count++;
+}
+
+static void hop_cost_print(const char *what, const struct hop_cost *cost)
+{
+	if (cost->count == 0) {
+		return;
+	}
+	LOG_INF("Channel %s us: %u hops, min %u avg %u max %u", what, cost->count, cost->min_us,
+		(uint32_t)(cost->sum_us / cost->count), cost->max_us);
+}
+
+static uint32_t hop_loss_per_mille(uint32_t received, uint32_t lost)
+{
+	uint32_t total = received + lost;
+
+	return total ? lost * 1000U / total : 0;
+}
+
+void hop_switch_record(uint8_t channel, uint32_t switch_us)
+{
+	hop_cost_record(&hop_result.switches, switch_us);
+	LOG_INF("Switched to channel %u in %u us", channel, switch_us);
+}
+
+void hop_frame_record(uint16_t tag, int64_t rx_us)
+{
+	if (hop_tag_is_switch(tag)) {
+		if (!hop_result.gap_open) {
+			hop_result.gap_open = true;
+			hop_result.gap_channel = hop_tag_channel(tag);
+			hop_result.gap_start_us = rx_us;
+		}
+		return;
+	}
+
+	if (hop_result.gap_open && hop_tag_is_point(tag) &&
+	    hop_tag_channel(tag) == hop_result.gap_channel) {
+		uint32_t gap = (uint32_t)CLAMP(rx_us - hop_result.gap_start_us, 0, UINT32_MAX);
+
+		hop_cost_record(&hop_result.gaps, gap);
+		hop_result.gap_open = false;
+		LOG_DBG("Receive gap to channel %u: %u us", hop_result.gap_channel, gap);
+	}
+}
+
+void hop_record(const struct latency_stats_summary *summary)
+{
+	uint8_t channel = hop_tag_channel(summary->tag);
+	struct hop_channel_result *result = NULL;
+
+	if (!hop_tag_is_point(summary->tag)) {
+		return;
+	}
+
+	LOG_INF("Channel %u dwell: rx %u lost %u p50 %u p99 %u max %u us", channel,
+		summary->received, summary->lost, summary->p50_us, summary->p99_us,
+		summary->max_us);
+
+	for (uint32_t i = 0; i < hop_result.num_channels; i++) {
+		if (hop_result.channels[i].channel == channel) {
+			result = &hop_result.channels[i];
+			break;
+		}
+	}
+	if (!result) {
+		if (hop_result.num_channels == ARRAY_SIZE(hop_result.channels)) {
+			return;
+		}
+		result = &hop_result.channels[hop_result.num_channels++];
+		result->channel = channel;
+		result->absolute = true;
+	}
+
+	result->dwells++;
+	result->received += summary->received;
+	result->lost += summary->lost;
+	if (summary->count) {
+		result->p50_us = MAX(result->p50_us, summary->p50_us);
+		result->p99_us = MAX(result->p99_us, summary->p99_us);
+		result->max_us = MAX(result->max_us, summary->max_us);
+		result->absolute &= summary->absolute;
+	}
+}
+
+void hop_report(void)
+{
+	const struct hop_channel_result *best = NULL;
+
+	for (uint32_t i = 0; i < hop_result.num_channels; i++) {
+		const struct hop_channel_result *result = &hop_result.channels[i];
+		uint32_t loss = hop_loss_per_mille(result->received, result->lost);
+
+		LOG_INF("Channel %u: %u dwells rx %u loss %u.%u%% p50 %u p99 %u max %u us",
+			result->channel, result->dwells, result->received, loss / 10, loss % 10,
+			result->p50_us, result->p99_us, result->max_us);
+
+		if (result->received == 0) {
+			continue;
+		}
+		/* Ranked by worst dwell p99, then by loss */
+		if (!best || result->p99_us < best->p99_us ||
+		    (result->p99_us == best->p99_us &&
+		     loss < hop_loss_per_mille(best->received, best->lost))) {
+			best = result;
+		}
+	}
+
+	if (best) {
+		if (!best->absolute) {
+			LOG_WRN("Latency is relative per dwell, ranking reflects delay variation");
+		}
+		LOG_INF("Best channel %u: p99 %u us", best->channel, best->p99_us);
+	}
+	hop_cost_print("switch", &hop_result.switches);
+	hop_cost_print("receive gap", &hop_result.gaps);
+
+	memset(&hop_result, 0, sizeof(hop_result));
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef HOP_UTILS_H
+#define HOP_UTILS_H
+
+#include <zephyr/kernel.h>
+
+#include "stats_utils.h"
+
+/* Channel hop tags: flag bit, switch bit, end bit, 8-bit channel. Frames of a
+ * dwell carry a point tag; before every hop the TX device sends a few switch
+ * tags on the old channel naming the new one, so the monitor RX device can
+ * follow the schedule without a configuration of its own. Throughput step tags
+ * stay below HOP_TAG_FLAG and sweep tags set bit 15, so none of them collide.
+ */
+#define HOP_TAG_FLAG         BIT(14)
+#define HOP_TAG_SWITCH       BIT(13)
+#define HOP_TAG_END          BIT(12) /* Last switch, back to the base channel */
+#define HOP_TAG_CHANNEL_MASK 0xff
+
+/* Length and interval of the switch announcement on the old channel */
+#define HOP_ANNOUNCE_DURATION_MS 10
+#define HOP_ANNOUNCE_INTERVAL_US 2000
+
+static inline uint16_t hop_tag_point(uint8_t channel)
+{
+	return HOP_TAG_FLAG | channel;
+}
+
+static inline uint16_t hop_tag_switch(uint8_t channel, bool end)
+{
+	return HOP_TAG_FLAG | HOP_TAG_SWITCH | (end ? HOP_TAG_END : 0) | channel;
+}
+
+static inline bool hop_tag_is_point(uint16_t tag)
+{
+	return (tag & (BIT(15) | HOP_TAG_FLAG | HOP_TAG_SWITCH)) == HOP_TAG_FLAG;
+}
+
+static inline bool hop_tag_is_switch(uint16_t tag)
+{
+	return (tag & (BIT(15) | HOP_TAG_FLAG | HOP_TAG_SWITCH)) == (HOP_TAG_FLAG | HOP_TAG_SWITCH);
+}
+
+static inline uint8_t hop_tag_channel(uint16_t tag)
+{
+	return tag & HOP_TAG_CHANNEL_MASK;
+}
+
+/**
+ * @brief Get a channel of the hop schedule
+ *
+ * The schedule is CONFIG_WIFI_LATENCY_TEST_CHANNEL_HOP_LIST repeated
+ * CONFIG_WIFI_LATENCY_TEST_CHANNEL_HOP_ROUNDS times.
+ *
+ * @param idx Dwell index, starting at 0
+ * @param channel Filled with the channel of the dwell
+ * @return 0 on success, -ENOENT if idx is past the last dwell,
+ *         -EINVAL if the list is malformed
+ */
+int hop_get_channel(uint32_t idx, uint8_t *channel);
+
+/**
+ * @brief Record the cost of a channel switch
+ *
+ * @param channel Channel switched to
+ * @param switch_us Time spent in wifi_set_channel()
+ */
+void hop_switch_record(uint8_t channel, uint32_t switch_us);
+
+/**
+ * @brief Record a frame received on the receiver during the hop schedule
+ *
+ * A switch announcement opens the receive gap of the hop, the first dwell
+ * frame on the new channel closes it. The gap covers the rest of the
+ * announcement, both channel switches and the first frame interval.
+ *
+ * @param tag Tag of the frame
+ * @param rx_us Local receive time of the frame
+ */
+void hop_frame_record(uint16_t tag, int64_t rx_us);
+
+/**
+ * @brief Record the statistics of a finished dwell on the receiver
+ *
+ * @param summary Statistics of the dwell, its tag identifies the channel
+ */
+void hop_record(const struct latency_stats_summary *summary);
+
+/**
+ * @brief Log the per-channel results, the best channel and the switch cost,
+ *        then clear them for the next schedule
+ */
+void hop_report(void);
+
+#endif /* HOP_UTILS_H */
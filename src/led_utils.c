@@ -7,11 +7,21 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <dk_buttons_and_leds.h>
+#if !IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_MARKER_LED)
+#include <soc.h>
+#include <hal/nrf_gpio.h>
+#endif
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_MARKER_TIMER)
+#include <nrfx_gpiote.h>
+#include <nrfx_timer.h>
+#include <helpers/nrfx_gppi.h>
+#endif
 
 #include "led_utils.h"
 
 LOG_MODULE_REGISTER(led_utils, CONFIG_LOG_DEFAULT_LEVEL);
 
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_MARKER_LED)
 /* LED definitions - Only 2 LEDs available on board */
 #define TX_TRIGGER_LED DK_LED1
 #define RX_TRIGGER_LED DK_LED2
@@ -91,3 +101,187 @@ void led_trigger_rx(void)
 	k_work_cancel_delayable(&rx_led_work);
 	k_work_schedule(&rx_led_work, K_MSEC(LED_TRIGGER_DURATION_MS));
 }
+#else /* Fast marker backends */
+
+/* Same pins as LED1/LED2, driven directly. The pins idle low and every event is
+ * a CONFIG_WIFI_LATENCY_TEST_MARKER_PULSE_US high pulse whose rising edge marks
+ * the event, so the LEDs stay lit between events on active-low boards.
+ */
+#define TX_MARKER_PSEL NRF_DT_GPIOS_TO_PSEL(DT_ALIAS(led0), gpios)
+#define RX_MARKER_PSEL NRF_DT_GPIOS_TO_PSEL(DT_ALIAS(led1), gpios)
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_MARKER_GPIO)
+static inline void marker_pulse(uint32_t psel)
+{
+	nrf_gpio_pin_set(psel);
+	k_busy_wait(CONFIG_WIFI_LATENCY_TEST_MARKER_PULSE_US);
+	nrf_gpio_pin_clear(psel);
+}
+
+static int marker_init(void)
+{
+	nrf_gpio_cfg_output(TX_MARKER_PSEL);
+	nrf_gpio_cfg_output(RX_MARKER_PSEL);
+	nrf_gpio_pin_clear(TX_MARKER_PSEL);
+	nrf_gpio_pin_clear(RX_MARKER_PSEL);
+	return 0;
+}
+
+void led_trigger_tx(void)
+{
+	marker_pulse(TX_MARKER_PSEL);
+}
+
+void led_trigger_rx(void)
+{
+	marker_pulse(RX_MARKER_PSEL);
+}
+#else /* CONFIG_WIFI_LATENCY_TEST_MARKER_TIMER */
+/* The CPU raises the pin through the GPIOTE SET task and starts a one-shot
+ * TIMER; its COMPARE0 event clears the pin over (D)PPI, so the pulse width is
+ * exact and nothing runs after the two register writes.
+ */
+struct marker_hw {
+	nrfx_timer_t timer;
+	uint32_t psel;
+	uint8_t gpiote_ch;
+	uint8_t gppi_ch;
+	volatile uint32_t *set_task;
+	volatile uint32_t *start_task;
+};
+
+static const nrfx_gpiote_t marker_gpiote = NRFX_GPIOTE_INSTANCE(0);
+
+static struct marker_hw tx_marker = {
+	.timer = NRFX_TIMER_INSTANCE(1),
+	.psel = TX_MARKER_PSEL,
+};
+
+static struct marker_hw rx_marker = {
+	.timer = NRFX_TIMER_INSTANCE(2),
+	.psel = RX_MARKER_PSEL,
+};
+
+static void marker_timer_handler(nrf_timer_event_t event_type, void *context)
+{
+	/* Interrupts stay disabled, the pulse ends in hardware */
+	ARG_UNUSED(event_type);
+	ARG_UNUSED(context);
+}
+
+static int marker_hw_init(struct marker_hw *m)
+{
+	nrfx_timer_config_t timer_cfg = NRFX_TIMER_DEFAULT_CONFIG(NRFX_MHZ_TO_HZ(1));
+	const nrfx_gpiote_output_config_t out_cfg = NRFX_GPIOTE_DEFAULT_OUTPUT_CONFIG;
+	nrfx_gpiote_task_config_t task_cfg = {
+		.polarity = NRF_GPIOTE_POLARITY_TOGGLE,
+		.init_val = NRF_GPIOTE_INITIAL_VALUE_LOW,
+	};
+	uint32_t pulse_ticks;
+	nrfx_err_t err;
+
+	err = nrfx_gpiote_channel_alloc(&marker_gpiote, &m->gpiote_ch);
+	if (err != NRFX_SUCCESS) {
+		LOG_ERR("No free GPIOTE channel for marker pin %u", m->psel);
+		return -ENODEV;
+	}
+
+	task_cfg.task_ch = m->gpiote_ch;
+	err = nrfx_gpiote_output_configure(&marker_gpiote, m->psel, &out_cfg, &task_cfg);
+	if (err != NRFX_SUCCESS) {
+		LOG_ERR("Failed to configure marker pin %u: 0x%08x", m->psel, err);
+		return -EIO;
+	}
+	nrfx_gpiote_out_task_enable(&marker_gpiote, m->psel);
+
+	timer_cfg.bit_width = NRF_TIMER_BIT_WIDTH_32;
+	err = nrfx_timer_init(&m->timer, &timer_cfg, marker_timer_handler);
+	if (err != NRFX_SUCCESS) {
+		LOG_ERR("Failed to initialize marker timer: 0x%08x", err);
+		return -EBUSY;
+	}
+	pulse_ticks = nrfx_timer_us_to_ticks(&m->timer, CONFIG_WIFI_LATENCY_TEST_MARKER_PULSE_US);
+	nrfx_timer_extended_compare(&m->timer, NRF_TIMER_CC_CHANNEL0, pulse_ticks,
+				    NRF_TIMER_SHORT_COMPARE0_STOP_MASK |
+					    NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK,
+				    false);
+
+	err = nrfx_gppi_channel_alloc(&m->gppi_ch);
+	if (err != NRFX_SUCCESS) {
+		LOG_ERR("No free (D)PPI channel for marker pin %u", m->psel);
+		return -ENODEV;
+	}
+	nrfx_gppi_channel_endpoints_setup(
+		m->gppi_ch, nrfx_timer_compare_event_address_get(&m->timer, NRF_TIMER_CC_CHANNEL0),
+		nrfx_gpiote_clr_task_address_get(&marker_gpiote, m->psel));
+	nrfx_gppi_channels_enable(BIT(m->gppi_ch));
+
+	m->set_task = (volatile uint32_t *)nrfx_gpiote_set_task_address_get(&marker_gpiote,
+									      m->psel);
+	m->start_task =
+		(volatile uint32_t *)nrfx_timer_task_address_get(&m->timer, NRF_TIMER_TASK_START);
+	return 0;
+}
+
+static inline void marker_hw_pulse(struct marker_hw *m)
+{
+	*m->set_task = 1;
+	*m->start_task = 1;
+}
+
+static int marker_init(void)
+{
+	int ret;
+
+	/* The GPIO driver normally owns GPIOTE already */
+	if (!nrfx_gpiote_init_check(&marker_gpiote) &&
+	    nrfx_gpiote_init(&marker_gpiote, 0) != NRFX_SUCCESS) {
+		LOG_ERR("Failed to initialize GPIOTE");
+		return -EIO;
+	}
+
+	ret = marker_hw_init(&tx_marker);
+	if (ret) {
+		return ret;
+	}
+	return marker_hw_init(&rx_marker);
+}
+
+void led_trigger_tx(void)
+{
+	marker_hw_pulse(&tx_marker);
+}
+
+void led_trigger_rx(void)
+{
+	marker_hw_pulse(&rx_marker);
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_MARKER_GPIO */
+
+int led_init(void)
+{
+	int ret;
+
+	LOG_INF("Initializing timing markers");
+
+	ret = marker_init();
+	if (ret) {
+		LOG_ERR("Failed to initialize timing markers: %d", ret);
+		return ret;
+	}
+
+	LOG_INF("P%u.%02u: TX marker, P%u.%02u: RX marker, %u us pulses", TX_MARKER_PSEL >> 5,
+		TX_MARKER_PSEL & 0x1f, RX_MARKER_PSEL >> 5, RX_MARKER_PSEL & 0x1f,
+		CONFIG_WIFI_LATENCY_TEST_MARKER_PULSE_US);
+	return 0;
+}
+
+void led_set_network_status(bool connected)
+{
+	if (connected) {
+		LOG_INF("Network connected");
+	} else {
+		LOG_INF("Network disconnected");
+	}
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_MARKER_LED */
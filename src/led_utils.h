@@ -25,11 +25,16 @@ void led_set_network_status(bool connected);
 
 /**
  * @brief Trigger LED1 to indicate packet transmission
+ *
+ * With a fast marker backend this emits a short pulse on the LED1 pin instead,
+ * see CONFIG_WIFI_LATENCY_TEST_MARKER.
  */
 void led_trigger_tx(void);
 
 /**
  * @brief Trigger LED2 to indicate packet reception
+ *
+ * With a fast marker backend this emits a short pulse on the LED2 pin instead.
  */
 void led_trigger_rx(void);
 
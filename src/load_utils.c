@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/socket.h>
+
+#include "load_utils.h"
+#include "pacing_utils.h"
+#include "udp_utils.h"
+
+LOG_MODULE_REGISTER(load_utils, CONFIG_LOG_DEFAULT_LEVEL);
+
+#define LOAD_STACK_SIZE 2048
+#define LOAD_PRIORITY   K_PRIO_PREEMPT(CONFIG_WIFI_LATENCY_TEST_LOAD_PRIORITY)
+#define LOAD_SIZE       CONFIG_WIFI_LATENCY_TEST_LOAD_SIZE
+#define LOAD_RATE_KBPS  CONFIG_WIFI_LATENCY_TEST_LOAD_RATE_KBPS
+/* Datagram spacing that gives the configured rate */
+#define LOAD_INTERVAL_US ((uint32_t)((uint64_t)LOAD_SIZE * 8 * USEC_PER_MSEC / LOAD_RATE_KBPS))
+
+BUILD_ASSERT(LOAD_SIZE >= sizeof(struct latency_probe_hdr), "Bulk datagram too small");
+
+static K_SEM_DEFINE(load_start_sem, 0, 1);
+static K_SEM_DEFINE(load_done_sem, 0, 1);
+static atomic_t load_active;
+static struct tx_pacer load_pacer;
+static struct sockaddr_in load_addr;
+static int load_socket = -1;
+static uint16_t load_station_id;
+
+/* Written by the bulk thread only, read after it finished */
+static uint32_t load_sent;
+static uint32_t load_full;
+static uint32_t load_errors;
+static int64_t load_start_ms;
+
+static void load_send(uint32_t seq)
+{
+	static uint8_t buf[LOAD_SIZE];
+	struct latency_probe probe = {
+		.flags = LATENCY_PROBE_FLAG_BULK,
+		.payload_len = LOAD_SIZE - sizeof(struct latency_probe_hdr),
+		.seq = seq,
+		.burst_len = 1,
+		.station_id = load_station_id,
+		.ac = CONFIG_WIFI_LATENCY_TEST_LOAD_AC,
+	};
+	int len;
+	int ret;
+
+	probe.tx_cycles = k_cycle_get_64();
+	len = udp_probe_encode(buf, sizeof(buf), &probe);
+
+	/* Never block: a full stack is what the load is meant to cause */
+	ret = zsock_sendto(load_socket, buf, len, ZSOCK_MSG_DONTWAIT,
+			   (struct sockaddr *)&load_addr, sizeof(load_addr));
+	if (ret >= 0) {
+		load_sent++;
+	} else if (errno == EAGAIN || errno == ENOMEM || errno == ENOBUFS) {
+		load_full++;
+	} else {
+		if (!load_errors) {
+			LOG_ERR("Bulk send failed: %d", errno);
+		}
+		load_errors++;
+	}
+}
+
+static void load_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		uint32_t seq = 0;
+
+		k_sem_take(&load_start_sem, K_FOREVER);
+
+		while (atomic_get(&load_active)) {
+			/* Lost datagrams keep their sequence number so the RX counts them */
+			load_send(seq++);
+			if (tx_pacer_wait(&load_pacer)) {
+				break;
+			}
+		}
+
+		k_sem_give(&load_done_sem);
+	}
+}
+
+K_THREAD_DEFINE(load_tid, LOAD_STACK_SIZE, load_thread, NULL, NULL, NULL, LOAD_PRIORITY, 0, 0);
+
+int load_start(const char *target_ip, uint16_t station_id)
+{
+	const char *ip = CONFIG_WIFI_LATENCY_TEST_LOAD_TARGET_IP[0]
+				 ? CONFIG_WIFI_LATENCY_TEST_LOAD_TARGET_IP
+				 : target_ip;
+	int ret;
+
+	if (atomic_get(&load_active)) {
+		return -EALREADY;
+	}
+	if (!ip || !ip[0]) {
+		LOG_ERR("No bulk destination, set CONFIG_WIFI_LATENCY_TEST_LOAD_TARGET_IP");
+		return -EINVAL;
+	}
+
+	ret = udp_client_init(&load_socket, &load_addr, ip, CONFIG_WIFI_LATENCY_TEST_SOCKET_PORT);
+	if (ret) {
+		return ret;
+	}
+	ret = udp_client_set_ac(load_socket, CONFIG_WIFI_LATENCY_TEST_LOAD_AC);
+	if (ret) {
+		udp_client_cleanup(load_socket);
+		load_socket = -1;
+		return ret;
+	}
+
+	load_station_id = station_id;
+	load_sent = 0;
+	load_full = 0;
+	load_errors = 0;
+	load_start_ms = k_uptime_get();
+
+	LOG_INF("Bulk load: %u kbit/s, %u byte datagrams every %u us on %s",
+		LOAD_RATE_KBPS, LOAD_SIZE, LOAD_INTERVAL_US,
+		udp_ac_name(CONFIG_WIFI_LATENCY_TEST_LOAD_AC));
+	/* Set up before waking the thread so load_stop() can always cancel it */
+	tx_pacer_init(&load_pacer, LOAD_INTERVAL_US, TX_PACING_FIXED, 0);
+	atomic_set(&load_active, 1);
+	k_sem_give(&load_start_sem);
+	return 0;
+}
+
+void load_stop(void)
+{
+	int64_t elapsed_ms;
+	uint32_t offered;
+
+	if (!atomic_cas(&load_active, 1, 0)) {
+		return;
+	}
+	tx_pacer_cancel(&load_pacer);
+	k_sem_take(&load_done_sem, K_FOREVER);
+
+	udp_client_cleanup(load_socket);
+	load_socket = -1;
+
+	elapsed_ms = MAX(k_uptime_get() - load_start_ms, 1);
+	offered = load_sent + load_full + load_errors;
+	LOG_INF("Bulk load: sent %u of %u datagrams, %u refused by a full stack, %u errors",
+		load_sent, offered, load_full, load_errors);
+	LOG_INF("Bulk load: %u kbit/s achieved over %lld ms",
+		(uint32_t)((uint64_t)load_sent * LOAD_SIZE * 8 / elapsed_ms), elapsed_ms);
+}
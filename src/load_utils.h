@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef LOAD_UTILS_H
+#define LOAD_UTILS_H
+
+#include <zephyr/kernel.h>
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_LOAD)
+/**
+ * @brief Start the background bulk sender
+ *
+ * Opens the bulk socket on CONFIG_WIFI_LATENCY_TEST_LOAD_AC and wakes the
+ * bulk thread, which sends CONFIG_WIFI_LATENCY_TEST_LOAD_SIZE byte datagrams
+ * at CONFIG_WIFI_LATENCY_TEST_LOAD_RATE_KBPS until load_stop().
+ *
+ * @param target_ip Destination used when CONFIG_WIFI_LATENCY_TEST_LOAD_TARGET_IP is empty
+ * @param station_id Station ID carried in every bulk datagram
+ * @return 0 on success, negative error code on failure
+ */
+int load_start(const char *target_ip, uint16_t station_id);
+
+/**
+ * @brief Stop the bulk sender and log its statistics
+ *
+ * Waits for the bulk thread to finish its current datagram. No-op if the
+ * sender is not running.
+ */
+void load_stop(void);
+#else
+static inline int load_start(const char *target_ip, uint16_t station_id)
+{
+	return 0;
+}
+
+static inline void load_stop(void)
+{
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_LOAD */
+
+#endif /* LOAD_UTILS_H */
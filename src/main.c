@@ -13,13 +13,20 @@
 #include <zephyr/net/conn_mgr_monitor.h>
 #include <zephyr/net/dhcpv4_server.h>
 #include <zephyr/net/net_event.h>
+#include <zephyr/net/net_if.h>
 #include <zephyr/net/net_mgmt.h>
 #include <zephyr/net/wifi_mgmt.h>
 
+#include "boot_utils.h"
+#include "engine_utils.h"
+#include "hop_utils.h"
 #include "led_utils.h"
 #include "net_event_mgmt_utils.h"
+#include "pacing_utils.h"
+#include "ps_utils.h"
+#include "params_utils.h"
 #include "raw_utils.h"
-#include "udp_utils.h"
+#include "sweep_utils.h"
 #include "wifi_utils.h"
 
 LOG_MODULE_REGISTER(main, CONFIG_LOG_DEFAULT_LEVEL);
@@ -34,190 +41,199 @@ extern struct k_sem ipv4_dhcp_bond_sem;
 extern struct k_sem station_connected_sem;
 extern bool dhcp_server_started;
 #endif
-/* Function declarations */
 
 #if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX)
 /* Button control for TX task */
-K_SEM_DEFINE(tx_start_sem, 0, 1);
-volatile bool tx_task_running = false;
-volatile bool tx_task_should_stop = false;
+static K_SEM_DEFINE(tx_start_sem, 0, 1);
+
+void latency_test_stop(void)
+{
+	/* Stop current TX task if running */
+	if (engine_running()) {
+		engine_stop();
+		LOG_INF("Stopping current TX task...");
+
+		/* Wait a bit for task to stop */
+		k_sleep(K_MSEC(100));
+	}
+}
+
+void latency_test_start(void)
+{
+	latency_test_stop();
+
+	/* Signal to start new TX task */
+	k_sem_give(&tx_start_sem);
+}
 
 /* Button callback function for TX device */
 static void button_handler(uint32_t button_state, uint32_t has_changed)
 {
 	if (has_changed & DK_BTN1_MSK && button_state & DK_BTN1_MSK) {
 		LOG_INF("Button 1 pressed - restarting TX task");
+		latency_test_start();
+	}
+}
 
-		/* Stop current TX task if running */
-		if (tx_task_running) {
-			tx_task_should_stop = true;
-			LOG_INF("Stopping current TX task...");
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_SWEEP)
+/* One fixed-length step per rate/flags/queue point, each tagged with its configuration */
+static int raw_tx_sweep(struct engine_session *session)
+{
+	const struct test_params *base = &session->params;
+	struct test_params point;
+	struct tx_step step;
+	uint32_t idx = 0;
+	int ret;
 
-			/* Wait a bit for task to stop */
-			k_sleep(K_MSEC(100));
+	while (!engine_stopping() && sweep_get_point(idx, base, &point, &step.tag) == 0) {
+		ret = raw_tx_configure(&point);
+		if (ret < 0) {
+			return ret;
 		}
 
-		/* Signal to start new TX task */
-		k_sem_give(&tx_start_sem);
+		LOG_INF("Sweep point %u: rate %u flags %u queue %u", idx, point.raw_rate,
+			point.raw_rate_flags, point.raw_queue);
+		step.interval_us = point.interval_us;
+		step.duration_ms = point.duration_ms;
+		ret = engine_run_step(session, &step, point.burst_len);
+		if (ret < 0) {
+			return ret;
+		}
+		idx++;
+	}
+
+	if (engine_stopping()) {
+		return 0;
 	}
-}
-#endif /* CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX */
 
-#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX) &&                                         \
-	IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_PACKET_TYPE_RAW)
-static void raw_tx_session(void)
+	/* Short trailer at the base configuration lets the receiver close the last point */
+	ret = raw_tx_configure(base);
+	if (ret < 0) {
+		return ret;
+	}
+	step.interval_us = SWEEP_END_INTERVAL_US;
+	step.duration_ms = SWEEP_END_DURATION_MS;
+	step.tag = SWEEP_TAG_END;
+	LOG_INF("Sweep of %u points done", idx);
+	return engine_run_step(session, &step, base->burst_len);
+}
+#elif IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_CHANNEL_HOP)
+/* Announce the next channel on the current one, then switch */
+static int raw_tx_hop_switch(struct engine_session *session, struct test_params *params,
+			     uint8_t channel, bool end)
 {
+	struct tx_step step = {
+		.interval_us = HOP_ANNOUNCE_INTERVAL_US,
+		.duration_ms = HOP_ANNOUNCE_DURATION_MS,
+		.tag = hop_tag_switch(channel, end),
+	};
+	uint64_t start;
 	int ret;
-	uint32_t packet_count = 0;
-	int64_t start_time;
-	uint32_t test_duration = CONFIG_WIFI_LATENCY_TEST_DURATION_MS;
-	uint32_t packet_interval = CONFIG_WIFI_LATENCY_TEST_INTERVAL_MS;
-	LOG_INF("Starting Raw TX session");
-	/* Mark task as running */
-	tx_task_running = true;
-	tx_task_should_stop = false;
-
-	ret = raw_tx_socket_init();
 
+	ret = engine_run_step(session, &step, 1);
 	if (ret < 0) {
-		LOG_ERR("Failed to initialize raw TX socket");
-		tx_task_running = false;
-		return;
+		return ret;
 	}
 
-	start_time = k_uptime_get();
-	/* Main transmission loop */
-	while ((k_uptime_get() - start_time) < test_duration && !tx_task_should_stop) {
+	/* The channel switch dominates raw_tx_configure() */
+	params->channel = channel;
+	start = k_cycle_get_64();
+	ret = raw_tx_configure(params);
+	if (ret < 0) {
+		return ret;
+	}
+	hop_switch_record(channel, k_cyc_to_us_floor64(k_cycle_get_64() - start));
+	return 0;
+}
 
-		/* Prepare and trigger LED before transmission */
-		led_trigger_tx();
-		/* Send raw packet */
-		ret = raw_tx_send_packet(packet_count);
+/* One dwell per channel of the schedule, each tagged with its channel */
+static int raw_tx_hop(struct engine_session *session)
+{
+	const struct test_params *base = &session->params;
+	struct test_params point = *base;
+	uint8_t base_channel = base->channel ? base->channel : CONFIG_RAW_TX_DEV_CHANNEL;
+	struct tx_step step;
+	uint8_t channel;
+	uint32_t idx = 0;
+	int ret = 0;
+
+	point.channel = base_channel;
+	while (!engine_stopping() && (ret = hop_get_channel(idx, &channel)) == 0) {
+		ret = raw_tx_hop_switch(session, &point, channel, false);
 		if (ret < 0) {
-			LOG_ERR("Failed to send raw packet: %d", ret);
-			break; /* Exit loop on error */
-		} else {
-			LOG_INF("Sent: Raw packet %u at %lld ms", packet_count, k_uptime_get());
+			break;
 		}
 
-		packet_count++;
-		/* Wait for next transmission with shorter intervals to check for stop
-		 * signal */
-		for (int i = 0; i < packet_interval / 10 && !tx_task_should_stop; i++) {
-			k_sleep(K_MSEC(10));
+		LOG_INF("Hop %u: channel %u", idx, channel);
+		step.interval_us = base->interval_us;
+		step.duration_ms = CONFIG_WIFI_LATENCY_TEST_CHANNEL_HOP_DWELL_MS;
+		step.tag = hop_tag_point(channel);
+		ret = engine_run_step(session, &step, base->burst_len);
+		if (ret < 0) {
+			break;
 		}
+		idx++;
 	}
-
-	if (tx_task_should_stop) {
-		LOG_INF("TX session stopped by button. Sent %u packets", packet_count);
-	} else {
-		LOG_INF("TX session completed. Sent %u packets", packet_count);
+	if (ret == -ENOENT) {
+		ret = 0;
 	}
-	/* Cleanup raw socket */
-	raw_tx_cleanup();
-	tx_task_running = false;
-	LOG_INF("Raw TX session completed");
-	/* Reset task state */
-	tx_task_should_stop = false;
-	tx_task_running = false;
-	LOG_INF("Raw TX task finished, Press Button 1 to restart packet transmission");
-}
 
-static void raw_tx_task(void)
-{
-	LOG_INF("TX device ready. Press Button 1 to start/restart packet transmission");
+	/* Take the receiver back to the base channel, it reports on the way. A
+	 * stopped session sends no announcement and leaves the receiver behind.
+	 */
+	if (point.channel != base_channel) {
+		int err = raw_tx_hop_switch(session, &point, base_channel, true);
 
-	/* Start first transmission session */
-	raw_tx_session();
-
-	/* Wait for button presses to restart transmission */
-	while (1) {
-		/* Wait for button press to restart */
-		k_sem_take(&tx_start_sem, K_FOREVER);
-
-		LOG_INF("Button 1 pressed - starting new TX session");
-		raw_tx_session();
+		ret = ret ? ret : err;
+		if (engine_stopping()) {
+			LOG_WRN("Hop stopped, the RX device may still be on another channel");
+		}
 	}
+	LOG_INF("Channel hop of %u dwells done", idx);
+	hop_report();
+	return ret;
 }
-#endif /* CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX &&                                               \
-	  CONFIG_WIFI_LATENCY_TEST_PACKET_TYPE_RAW */
+#endif /* CONFIG_WIFI_LATENCY_TEST_SWEEP */
 
-#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX) &&                                         \
-	IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_PACKET_TYPE_UDP)
-
-static void udp_tx_session(void)
+static void tx_session(void)
 {
+	struct engine_session session;
 	int ret;
-	int udp_socket;
-	struct sockaddr_in server_addr;
-	uint32_t packet_count = 0;
-	int64_t start_time;
-	uint32_t test_duration = CONFIG_WIFI_LATENCY_TEST_DURATION_MS;
-	uint32_t packet_interval = CONFIG_WIFI_LATENCY_TEST_INTERVAL_MS;
-
-	LOG_INF("Starting UDP TX session");
-
-	/* Mark task as running */
-	tx_task_running = true;
-	tx_task_should_stop = false;
-
-	/* Create UDP socket */
-	ret = udp_client_init(&udp_socket, &server_addr, CONFIG_UDP_TX_DEV_TARGET_IP,
-			      CONFIG_WIFI_LATENCY_TEST_SOCKET_PORT);
-	if (ret) {
-		LOG_ERR("Failed to initialize UDP client: %d", ret);
-		tx_task_running = false;
+
+	LOG_INF("Starting TX session");
+	ret = engine_session_open(&session);
+	if (ret < 0) {
+		LOG_ERR("Failed to open TX session: %d", ret);
 		return;
 	}
 
-	start_time = k_uptime_get();
-
-	/* Main transmission loop */
-	while ((k_uptime_get() - start_time) < test_duration && !tx_task_should_stop) {
-		char payload[64];
-		int64_t current_time = k_uptime_get();
-
-		/* Prepare payload with timestamp and packet count */
-		snprintf(payload, sizeof(payload), "Packet_%u_Time_%lld", packet_count,
-			 current_time);
-
-		/* Trigger LED before transmission */
-		led_trigger_tx();
-
-		/* Send UDP packet */
-		ret = udp_send(udp_socket, &server_addr, payload, strlen(payload));
-		if (ret < 0) {
-			LOG_ERR("Failed to send UDP packet: %d", ret);
-		} else {
-			LOG_INF("Sent: UDP packet %u at %lld ms", packet_count, current_time);
-			packet_count++;
-		}
-
-		/* Wait for next transmission with shorter intervals to check for stop
-		 * signal */
-		for (int i = 0; i < packet_interval / 10 && !tx_task_should_stop; i++) {
-			k_sleep(K_MSEC(10));
-		}
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_SWEEP)
+	ret = raw_tx_sweep(&session);
+	if (ret < 0) {
+		LOG_ERR("Sweep aborted: %d", ret);
 	}
-
-	if (tx_task_should_stop) {
-		LOG_INF("TX session stopped by button. Sent %u packets", packet_count);
-	} else {
-		LOG_INF("TX session completed. Sent %u packets", packet_count);
+#elif IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_CHANNEL_HOP)
+	ret = raw_tx_hop(&session);
+	if (ret < 0) {
+		LOG_ERR("Channel hop aborted: %d", ret);
+	}
+#else
+	ret = engine_session_run(&session);
+	if (ret < 0) {
+		LOG_ERR("TX session aborted: %d", ret);
 	}
+#endif
 
-	udp_client_cleanup(udp_socket);
-	tx_task_running = false;
-	LOG_INF("UDP TX task finished, Press Button 1 to start/restart packet "
-		"transmission");
+	engine_session_close(&session);
+	LOG_INF("TX task finished, Press Button 1 to start/restart packet transmission");
 }
 
-static void udp_tx_task(void)
+static void tx_task(void)
 {
 	LOG_INF("TX device ready. Press Button 1 to start/restart packet transmission");
 
 	/* Start first transmission session */
-	udp_tx_session();
+	tx_session();
 
 	/* Wait for button presses to restart transmission */
 	while (1) {
@@ -225,62 +241,48 @@ static void udp_tx_task(void)
 		k_sem_take(&tx_start_sem, K_FOREVER);
 
 		LOG_INF("Button 1 pressed - starting new TX session");
-		udp_tx_session();
+		tx_session();
 	}
 }
-#endif /* CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX &&                                               \
-	  CONFIG_WIFI_LATENCY_TEST_PACKET_TYPE_UDP */
+#endif /* CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX */
+
+/* UDP TX, connected raw injection, UDP RX in station mode and promiscuous capture */
+#define NETWORK_STA_LINK                                                                           \
+	((IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX) &&                                   \
+	  IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRANSPORT_UDP)) ||                                   \
+	 IS_ENABLED(CONFIG_RAW_TX_DEV_MODE_CONNECTED) || IS_ENABLED(CONFIG_UDP_RX_DEV_MODE_STA) || \
+	 IS_ENABLED(CONFIG_RAW_RX_DEV_MODE_PROMISCUOUS))
 
-#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_PACKET_TYPE_UDP) &&                                        \
-	IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_RX)
-static void udp_rx_task(void)
+#if NETWORK_STA_LINK
+/* Connect to the AP with the stored credentials and wait for the DHCP lease */
+static int network_connect(void)
 {
 	int ret;
-	int udp_socket;
-	uint32_t packet_count = 0;
 
-	/* Create UDP socket for receiving */
-	ret = udp_server_init(&udp_socket, CONFIG_WIFI_LATENCY_TEST_SOCKET_PORT);
+	ret = conn_mgr_all_if_connect(true);
 	if (ret) {
-		LOG_ERR("Failed to initialize UDP server: %d", ret);
-		return;
-	}
-
-	LOG_INF("UDP server listening on port %d", CONFIG_WIFI_LATENCY_TEST_SOCKET_PORT);
-
-	/* Main reception loop */
-	while (1) {
-		char buffer[256];
-		int64_t current_time = k_uptime_get();
-
-		ret = udp_receive(udp_socket, buffer, sizeof(buffer));
-		if (ret > 0) {
-			/* Trigger LED when packet received */
-			led_trigger_rx();
-
-			buffer[ret] = '\0'; /* Null-terminate */
-			LOG_INF("Received: %s at %lld ms", buffer, current_time);
-			packet_count++;
-		} else if (ret < 0) {
-			LOG_ERR("Failed to receive UDP packet: %d", ret);
-			k_sleep(K_MSEC(100));
-		}
+		LOG_ERR("Failed to initiate network connection: %d", ret);
+		return ret;
 	}
+	LOG_INF("Network connection initiated, waiting for IPv4 DHCP bond...");
+	k_sem_take(&ipv4_dhcp_bond_sem, K_FOREVER);
 
-	LOG_INF("RX task completed. Received %u packets", packet_count);
-	udp_server_cleanup(udp_socket);
+	return 0;
 }
-#endif /* CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_RX */
+#endif /* NETWORK_STA_LINK */
 
 int main(void)
 {
 	int ret;
 
+	boot_mark(BOOT_PHASE_MAIN);
 	LOG_INF("Starting Wi-Fi Packet Latency Test Application");
 #if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_PACKET_TYPE_UDP)
 	LOG_INF("Transmission mode: UDP packets");
 #elif IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_PACKET_TYPE_RAW)
 	LOG_INF("Transmission mode: Raw IEEE 802.11 packets");
+#elif IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_PACKET_TYPE_INTERLEAVED)
+	LOG_INF("Transmission mode: UDP and raw IEEE 802.11 packets interleaved");
 #endif
 
 	/* Initialize LED GPIO for timing measurements */
@@ -290,6 +292,17 @@ int main(void)
 		return ret;
 	}
 
+	ret = params_init();
+	if (ret) {
+		LOG_ERR("Failed to load test parameters: %d", ret);
+		return ret;
+	}
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_FAST_CONNECT)
+	/* Settings are loaded, pin the credentials before the first connect */
+	wifi_link_cache_apply();
+#endif
+
 	ret = init_network_events();
 	if (ret) {
 		LOG_ERR("Failed to initialize network events: %d", ret);
@@ -298,11 +311,20 @@ int main(void)
 	k_sem_take(&wpa_supplicant_ready_sem, K_FOREVER);
 	LOG_INF("WPA Supplicant is ready!");
 
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_POWER_SAVE)
+	/* The listen interval goes into the association request */
+	ret = ps_init();
+	if (ret) {
+		LOG_ERR("Failed to configure power save: %d", ret);
+		return ret;
+	}
+#endif
+
 #if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX)
 	/* TX device */
 	LOG_INF("Device role: TX");
 
-#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_PACKET_TYPE_RAW)
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRANSPORT_RAW)
 	/* Raw packet transmission */
 	ret = raw_tx_init();
 	if (ret) {
@@ -316,27 +338,18 @@ int main(void)
 		LOG_ERR("Timeout waiting for interface to become operational");
 		return ret;
 	}
+	LOG_INF("Raw packet TX initialized");
+#endif
 
-	/* Initialize buttons for TX control */
-	ret = dk_buttons_init(button_handler);
-	if (ret) {
-		LOG_ERR("Failed to initialize buttons: %d", ret);
-		return ret;
-	}
-
-	LOG_INF("Raw packet TX initialized, starting TX task");
-	LOG_INF("Button 1: Start/restart raw packet transmission");
-	raw_tx_task();
-
-#elif IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_PACKET_TYPE_UDP)
-	/* UDP packet transmission */
-	ret = conn_mgr_all_if_connect(true);
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRANSPORT_UDP) ||                                          \
+	IS_ENABLED(CONFIG_RAW_TX_DEV_MODE_CONNECTED)
+	/* UDP probes and connected raw injection need the association */
+	ret = network_connect();
 	if (ret) {
-		LOG_ERR("Failed to initiate network connection: %d", ret);
 		return ret;
 	}
-	LOG_INF("Network connection initiated, waiting for IPv4 DHCP bond...");
-	k_sem_take(&ipv4_dhcp_bond_sem, K_FOREVER);
+	LOG_INF("Network connected successfully");
+#endif
 
 	/* Initialize buttons for TX control */
 	ret = dk_buttons_init(button_handler);
@@ -345,16 +358,12 @@ int main(void)
 		return ret;
 	}
 
-	LOG_INF("Network connected successfully, starting TX task");
+	LOG_INF("Starting TX task");
 	LOG_INF("Button 1: Start/restart packet transmission");
-	udp_tx_task();
-#endif
+	tx_task();
 
 #elif IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_RX)
 
-#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_PACKET_TYPE_RAW)
-	/* Raw packet reception */
-
 #if IS_ENABLED(CONFIG_RAW_RX_DEV_MODE_MONITOR)
 	/* Monitor mode */
 	LOG_INF("Device role: RX (Monitor mode)");
@@ -369,31 +378,8 @@ int main(void)
 		LOG_ERR("Timeout waiting for interface to become operational");
 		return ret;
 	}
-	raw_rx_dev_monitor_task();
-
-#elif IS_ENABLED(CONFIG_RAW_RX_DEV_MODE_PROMISCUOUS)
-	/* Promiscuous mode */
-	LOG_INF("Device role: RX (Promiscuous mode)");
-
-	/* Need to connect to AP first for promiscuous mode */
-	ret = connect_with_retry(60);
-	if (ret) {
-		LOG_ERR("Failed to establish network connection for promiscuous mode");
-		return ret;
-	}
-
-	ret = raw_rx_dev_promiscuous_init();
-	if (ret) {
-		LOG_ERR("Failed to initialize promiscuous mode: %d", ret);
-		return ret;
-	}
-	raw_rx_dev_promiscuous_task();
-#endif
 
-#elif IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_PACKET_TYPE_UDP)
-	/* UDP packet reception */
-
-#if IS_ENABLED(CONFIG_UDP_RX_DEV_MODE_SOFTAP)
+#elif IS_ENABLED(CONFIG_UDP_RX_DEV_MODE_SOFTAP)
 	/* RX device in SoftAP mode */
 	LOG_INF("Device role: RX (SoftAP mode)");
 
@@ -420,28 +406,36 @@ int main(void)
 
 	LOG_INF("Station connected! Starting RX server...");
 
-#elif IS_ENABLED(CONFIG_UDP_RX_DEV_MODE_STA)
-	/* RX device in station mode */
+#else
+	/* Promiscuous raw capture and the UDP server both run on the station link */
 	LOG_INF("Device role: RX (Station mode)");
-	ret = conn_mgr_all_if_connect(true);
+	ret = network_connect();
 	if (ret) {
-		LOG_ERR("Failed to initiate network connection: %d", ret);
 		return ret;
 	}
-	LOG_INF("Network connection initiated, waiting for IPv4 DHCP bond...");
-	k_sem_take(&ipv4_dhcp_bond_sem, K_FOREVER);
+	LOG_INF("Network connected successfully");
 
-	LOG_INF("Network connected successfully, starting RX task");
-#endif /* CONFIG_UDP_RX_DEV_MODE_SOFTAP */
-
-	udp_rx_task();
+#if IS_ENABLED(CONFIG_RAW_RX_DEV_MODE_PROMISCUOUS)
+	LOG_INF("Raw capture: promiscuous mode");
+	ret = raw_rx_dev_promiscuous_init();
+	if (ret) {
+		LOG_ERR("Failed to initialize promiscuous mode: %d", ret);
+		return ret;
+	}
 #endif
+#endif /* CONFIG_RAW_RX_DEV_MODE_MONITOR */
+
+	/* Every transport receives in its own threads from here on */
+	ret = engine_rx_start();
+	if (ret) {
+		return ret;
+	}
+	LOG_INF("RX task started");
 
 #else
 	LOG_ERR("No valid device role configured");
 	return -1;
 #endif
 
-	/* Should not reach here */
 	return 0;
 }
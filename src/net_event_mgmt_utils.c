@@ -11,7 +11,9 @@
 #include <zephyr/net/socket.h>
 #include <stdio.h>
 
+#include "boot_utils.h"
 #include "net_event_mgmt_utils.h"
+#include "ps_utils.h"
 #include "wifi_utils.h"
 
 LOG_MODULE_REGISTER(net_event_mgmt_utils, CONFIG_LOG_DEFAULT_LEVEL);
@@ -66,6 +68,7 @@ static void l2_iface_event_handler(struct net_mgmt_event_callback *cb, uint32_t
 				iface);
 		}
 		LOG_INF("Network interface %s is up", ifname);
+		boot_mark(BOOT_PHASE_IFACE_UP);
 		k_sem_give(&iface_up_sem);
 		break;
 	case NET_EVENT_IF_DOWN:
@@ -84,37 +87,52 @@ static void l2_iface_event_handler(struct net_mgmt_event_callback *cb, uint32_t
 
 #if IS_ENABLED(CONFIG_WIFI_NM_WPA_SUPPLICANT_AP)
 
-static int get_station_ip_address(const uint8_t *mac, struct in_addr *ip_addr)
+#if IS_ENABLED(CONFIG_NET_DHCPV4_SERVER)
+struct softap_lease_lookup {
+	const struct in_addr *addr;
+	uint8_t mac[WIFI_MAC_ADDR_LEN];
+	bool found;
+};
+
+static void softap_lease_cb(struct net_if *iface, struct dhcpv4_addr_slot *lease, void *user_data)
 {
-	struct net_if *iface;
-	int station_count = 0;
+	struct softap_lease_lookup *lookup = user_data;
 
-	iface = net_if_get_first_wifi();
-	if (!iface) {
-		return -1;
+	/* Without option 61 the client ID is the hardware type followed by the MAC */
+	if (lookup->found || lease->state != DHCPV4_SERVER_ADDR_ALLOCATED ||
+	    !net_ipv4_addr_cmp(&lease->addr, lookup->addr) ||
+	    lease->client_id.len != WIFI_MAC_ADDR_LEN + 1) {
+		return;
+	}
+
+	memcpy(lookup->mac, &lease->client_id.buf[1], WIFI_MAC_ADDR_LEN);
+	lookup->found = true;
+}
+
+/* Bind a lease of the DHCP server to a connected station, call with softap_mutex held */
+static struct softap_station *softap_station_from_lease(const struct in_addr *ip_addr)
+{
+	struct softap_lease_lookup lookup = {
+		.addr = ip_addr,
+	};
+	struct net_if *iface = net_if_get_first_wifi();
+
+	if (!iface || net_dhcpv4_server_foreach_lease(iface, softap_lease_cb, &lookup) ||
+	    !lookup.found) {
+		return NULL;
 	}
 
-	/* Count existing stations to assign next sequential IP */
-	k_mutex_lock(&softap_mutex, K_FOREVER);
 	for (int i = 0; i < MAX_SOFTAP_STATIONS; i++) {
-		if (connected_stations[i].valid && connected_stations[i].ip_addr.s_addr != 0) {
-			station_count++;
+		if (connected_stations[i].valid &&
+		    memcmp(connected_stations[i].info.mac, lookup.mac, WIFI_MAC_ADDR_LEN) == 0) {
+			connected_stations[i].ip_addr = *ip_addr;
+			return &connected_stations[i];
 		}
 	}
-	k_mutex_unlock(&softap_mutex);
 
-	/* Assign IP based on DHCP pool logic: 192.168.1.2, 192.168.1.3, etc. */
-	/* DHCP server starts from 192.168.1.2, so assign sequentially */
-	uint32_t base_ip = 0xC0A80102; /* 192.168.1.2 in network byte order (host order) */
-	uint32_t assigned_ip = base_ip + station_count;
-
-	ip_addr->s_addr = htonl(assigned_ip);
-
-	LOG_DBG("Assigned IP for station: 192.168.1.%d (station count: %d)", 2 + station_count,
-		station_count + 1);
-
-	return 0;
+	return NULL;
 }
+#endif /* CONFIG_NET_DHCPV4_SERVER */
 
 static void handle_softap_enable_result(struct net_mgmt_event_callback *cb)
 {
@@ -124,6 +142,7 @@ static void handle_softap_enable_result(struct net_mgmt_event_callback *cb)
 		LOG_ERR("SoftAP enable failed: %d", status->status);
 	} else {
 		LOG_INF("SoftAP enabled successfully");
+		boot_mark(BOOT_PHASE_SOFTAP_ENABLED);
 		/* Signal network connectivity for SoftAP mode */
 		k_sem_give(&ipv4_dhcp_bond_sem);
 	}
@@ -132,7 +151,6 @@ static void handle_softap_enable_result(struct net_mgmt_event_callback *cb)
 static void handle_station_connected(struct net_mgmt_event_callback *cb)
 {
 	const struct wifi_ap_sta_info *sta_info = (const struct wifi_ap_sta_info *)cb->info;
-	int station_slot = -1;
 
 	k_mutex_lock(&softap_mutex, K_FOREVER);
 
@@ -141,38 +159,20 @@ static void handle_station_connected(struct net_mgmt_event_callback *cb)
 		if (!connected_stations[i].valid) {
 			connected_stations[i].valid = true;
 			connected_stations[i].info = *sta_info;
-			connected_stations[i].ip_addr.s_addr = 0; /* Initialize as unassigned */
-			station_slot = i;
+			/* Resolved from the DHCP lease once the station's first packet names it */
+			connected_stations[i].ip_addr.s_addr = 0;
 			break;
 		}
 	}
 
 	k_mutex_unlock(&softap_mutex);
 
-	uint8_t mac_str[18];
-	snprintf(mac_str, sizeof(mac_str), "%02x:%02x:%02x:%02x:%02x:%02x", sta_info->mac[0],
-		 sta_info->mac[1], sta_info->mac[2], sta_info->mac[3], sta_info->mac[4],
-		 sta_info->mac[5]);
-
-	/* Try to get IP address after a short delay for DHCP assignment */
-	k_sleep(K_MSEC(1000)); /* Wait 1 second for DHCP to assign IP */
-
-	if (station_slot >= 0) {
-		struct in_addr ip_addr;
-		if (get_station_ip_address(sta_info->mac, &ip_addr) == 0) {
-			k_mutex_lock(&softap_mutex, K_FOREVER);
-			connected_stations[station_slot].ip_addr = ip_addr;
-			k_mutex_unlock(&softap_mutex);
-
-			char ip_str[INET_ADDRSTRLEN];
-			inet_ntop(AF_INET, &ip_addr, ip_str, sizeof(ip_str));
-			LOG_INF("Station %s assigned IP: %s", mac_str, ip_str);
-		} else {
-			LOG_WRN("Could not determine IP address for station %s", mac_str);
-		}
-	}
+	LOG_INF("Station connected: MAC=%02x:%02x:%02x:%02x:%02x:%02x", sta_info->mac[0],
+		sta_info->mac[1], sta_info->mac[2], sta_info->mac[3], sta_info->mac[4],
+		sta_info->mac[5]);
 
 	/* Signal that a station has connected - this will allow UDP RX task to start */
+	boot_mark(BOOT_PHASE_STATION_CONNECTED);
 	k_sem_give(&station_connected_sem);
 	LOG_INF("New device connected with AP!");
 }
@@ -228,6 +228,40 @@ static void handle_station_disconnected(struct net_mgmt_event_callback *cb)
 	}
 }
 
+int softap_station_get_mac(const struct in_addr *ip_addr, uint8_t *mac)
+{
+	struct softap_station *station = NULL;
+
+	k_mutex_lock(&softap_mutex, K_FOREVER);
+	for (int i = 0; i < MAX_SOFTAP_STATIONS; i++) {
+		if (connected_stations[i].valid &&
+		    connected_stations[i].ip_addr.s_addr == ip_addr->s_addr) {
+			station = &connected_stations[i];
+			break;
+		}
+	}
+#if IS_ENABLED(CONFIG_NET_DHCPV4_SERVER)
+	if (!station) {
+		station = softap_station_from_lease(ip_addr);
+		if (station) {
+			char ip_str[INET_ADDRSTRLEN];
+
+			inet_ntop(AF_INET, ip_addr, ip_str, sizeof(ip_str));
+			LOG_INF("Station %02x:%02x:%02x:%02x:%02x:%02x assigned IP: %s",
+				station->info.mac[0], station->info.mac[1], station->info.mac[2],
+				station->info.mac[3], station->info.mac[4], station->info.mac[5],
+				ip_str);
+		}
+	}
+#endif
+	if (station) {
+		memcpy(mac, station->info.mac, WIFI_MAC_ADDR_LEN);
+	}
+	k_mutex_unlock(&softap_mutex);
+
+	return station ? 0 : -ENOENT;
+}
+
 static void l2_wifi_softap_event_handler(struct net_mgmt_event_callback *cb, uint32_t mgmt_event,
 					 struct net_if *iface)
 {
@@ -258,9 +292,23 @@ static void l2_wifi_conn_event_handler(struct net_mgmt_event_callback *cb, uint3
 		if (status->status == 0) {
 			/* Connection successful */
 			LOG_INF("WiFi is connected!");
+			boot_mark(BOOT_PHASE_WIFI_CONNECTED);
 			/* Print detailed WiFi status when connected */
 			wifi_print_status();
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_FAST_CONNECT)
+			wifi_link_cache_update();
+#endif
+			ps_link_up();
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_STATIC_IPV4)
+			/* The static address is usable as soon as the link is, no DHCP round */
+			boot_mark(BOOT_PHASE_IPV4_READY);
+			k_sem_give(&ipv4_dhcp_bond_sem);
+#endif
 		} else {
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_FAST_CONNECT)
+			/* The AP may have moved, scan all channels on the next attempt */
+			wifi_link_cache_invalidate();
+#endif
 			/* Decode common error codes */
 			switch (status->status) {
 			case 1:
@@ -288,6 +336,8 @@ static void l2_wifi_conn_event_handler(struct net_mgmt_event_callback *cb, uint3
 	case NET_EVENT_WIFI_DISCONNECT_RESULT: {
 		const struct wifi_status *status = (const struct wifi_status *)cb->info;
 		LOG_INF("WiFi disconnected: status=%d", status ? status->status : -1);
+		boot_restart();
+		ps_link_down();
 	} break;
 
 	default:
@@ -303,6 +353,7 @@ static void l3_wpa_supp_event_handler(struct net_mgmt_event_callback *cb, uint32
 	switch (mgmt_event) {
 	case NET_EVENT_SUPPLICANT_READY:
 		LOG_INF("WPA Supplicant is ready!");
+		boot_mark(BOOT_PHASE_SUPPLICANT_READY);
 		k_sem_give(&wpa_supplicant_ready_sem);
 		break;
 	case NET_EVENT_SUPPLICANT_NOT_READY:
@@ -327,6 +378,7 @@ static void l3_ipv4_event_handler(struct net_mgmt_event_callback *cb, uint32_t m
 		LOG_INF("Network DHCP bound!");
 		/* Print IP address information */
 		wifi_print_dhcp_ip(cb);
+		boot_mark(BOOT_PHASE_IPV4_READY);
 		/* Signal network connectivity */
 		k_sem_give(&ipv4_dhcp_bond_sem);
 		break;
@@ -10,6 +10,7 @@
 #include <zephyr/kernel.h>
 #include <zephyr/net/net_mgmt.h>
 #include <zephyr/net/net_event.h>
+#include <zephyr/net/net_ip.h>
 #include <zephyr/net/wifi_mgmt.h>
 
 /**
@@ -28,6 +29,15 @@ extern struct k_sem ipv4_dhcp_bond_sem;
 
 #if IS_ENABLED(CONFIG_WIFI_NM_WPA_SUPPLICANT_AP)
 extern struct k_sem station_connected_sem;
+
+/**
+ * @brief Look up the MAC address of a connected SoftAP station by its IP address
+ *
+ * @param ip_addr Station IP address
+ * @param mac Filled with the WIFI_MAC_ADDR_LEN byte MAC address
+ * @return 0 on success, -ENOENT if no connected station has this address
+ */
+int softap_station_get_mac(const struct in_addr *ip_addr, uint8_t *mac);
 #endif
 
 #endif /* NET_EVENT_MGMT_UTILS_H */
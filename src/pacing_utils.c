@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/random/random.h>
+#include <math.h>
+
+#include "pacing_utils.h"
+
+LOG_MODULE_REGISTER(pacing_utils, CONFIG_LOG_DEFAULT_LEVEL);
+
+static uint32_t tx_pacer_next_gap_us(struct tx_pacer *pacer)
+{
+	switch (pacer->mode) {
+	case TX_PACING_JITTER: {
+		uint32_t span =
+			(uint32_t)(((uint64_t)pacer->interval_us * pacer->jitter_pct) / 100);
+
+		if (span == 0) {
+			return pacer->interval_us;
+		}
+		/* Uniform in [interval - span, interval + span] */
+		return pacer->interval_us - span + (sys_rand32_get() % (2 * span + 1));
+	}
+	case TX_PACING_POISSON: {
+		/* Inverse transform sampling, u in (0, 1] */
+		float u = ((float)sys_rand32_get() + 1.0f) / 4294967296.0f;
+
+		return (uint32_t)(-logf(u) * (float)pacer->interval_us);
+	}
+	case TX_PACING_FIXED:
+	default:
+		return pacer->interval_us;
+	}
+}
+
+void tx_pacer_init(struct tx_pacer *pacer, uint32_t interval_us, enum tx_pacing_mode mode,
+		   uint8_t jitter_pct)
+{
+	k_sem_init(&pacer->cancel_sem, 0, 1);
+	pacer->start_ticks = k_uptime_ticks();
+	pacer->next_us = 0;
+	pacer->interval_us = interval_us;
+	pacer->jitter_pct = MIN(jitter_pct, 100);
+	pacer->mode = mode;
+	pacer->overruns = 0;
+
+	LOG_DBG("Pacer started: interval %u us, mode %d", interval_us, mode);
+}
+
+int tx_pacer_wait(struct tx_pacer *pacer)
+{
+	int64_t deadline;
+	int64_t now;
+	int ret;
+
+	if (pacer->interval_us == 0) {
+		/* Open loop: let the network threads drain, keep a stop request sticky */
+		k_yield();
+		return k_sem_count_get(&pacer->cancel_sem) ? -ECANCELED : 0;
+	}
+
+	pacer->next_us += tx_pacer_next_gap_us(pacer);
+	deadline = pacer->start_ticks + (int64_t)k_us_to_ticks_ceil64(pacer->next_us);
+
+	now = k_uptime_ticks();
+	if (now - deadline > (int64_t)k_us_to_ticks_ceil64(pacer->interval_us)) {
+		/* Too far behind, restart the schedule from now */
+		pacer->overruns++;
+		pacer->start_ticks = now;
+		pacer->next_us = 0;
+		deadline = now;
+	}
+
+	/* The cancel semaphore doubles as the sleep, so a stop request wakes us
+	 * immediately instead of at the next polling slot.
+	 */
+	ret = k_sem_take(&pacer->cancel_sem, K_TIMEOUT_ABS_TICKS(deadline));
+	if (ret == 0) {
+		/* Keep the semaphore given so later waits also return at once */
+		k_sem_give(&pacer->cancel_sem);
+		return -ECANCELED;
+	}
+
+	return 0;
+}
+
+int tx_pacer_get_step(uint32_t idx, const struct test_params *params, struct tx_step *step)
+{
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_THROUGHPUT_STEPPED)
+	uint32_t rate_pps;
+
+	if (idx >= CONFIG_WIFI_LATENCY_TEST_THROUGHPUT_STEPS) {
+		return -ENOENT;
+	}
+
+	rate_pps = CONFIG_WIFI_LATENCY_TEST_THROUGHPUT_START_PPS +
+		   idx * CONFIG_WIFI_LATENCY_TEST_THROUGHPUT_STEP_PPS;
+	/* Rates count packets, each deadline sends a whole burst */
+	step->interval_us = (uint64_t)USEC_PER_SEC * params->burst_len / MAX(rate_pps, 1);
+	step->duration_ms = CONFIG_WIFI_LATENCY_TEST_THROUGHPUT_STEP_DURATION_MS;
+	step->tag = idx + 1;
+#else
+	if (idx > 0) {
+		return -ENOENT;
+	}
+
+	step->interval_us =
+		IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_THROUGHPUT_OPEN_LOOP) ? 0 : params->interval_us;
+	step->duration_ms = params->duration_ms;
+	step->tag = IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_THROUGHPUT) ? 1 : 0;
+#endif
+	return 0;
+}
+
+void tx_pacer_cancel(struct tx_pacer *pacer)
+{
+	k_sem_give(&pacer->cancel_sem);
+}
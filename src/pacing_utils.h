@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef PACING_UTILS_H
+#define PACING_UTILS_H
+
+#include <zephyr/kernel.h>
+
+#include "params_utils.h"
+
+/* Interval from Kconfig, microsecond setting takes precedence when non-zero */
+#define TX_PACER_DEFAULT_INTERVAL_US                                                               \
+	(CONFIG_WIFI_LATENCY_TEST_INTERVAL_US > 0 ? CONFIG_WIFI_LATENCY_TEST_INTERVAL_US          \
+						   : CONFIG_WIFI_LATENCY_TEST_INTERVAL_MS * 1000U)
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_PACING_POISSON)
+#define TX_PACER_DEFAULT_MODE TX_PACING_POISSON
+#elif IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_PACING_JITTER)
+#define TX_PACER_DEFAULT_MODE TX_PACING_JITTER
+#else
+#define TX_PACER_DEFAULT_MODE TX_PACING_FIXED
+#endif
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_PACING_JITTER)
+#define TX_PACER_DEFAULT_JITTER_PCT CONFIG_WIFI_LATENCY_TEST_PACING_JITTER_PERCENT
+#else
+#define TX_PACER_DEFAULT_JITTER_PCT 0
+#endif
+
+enum tx_pacing_mode {
+	TX_PACING_FIXED,   /* Constant interval */
+	TX_PACING_JITTER,  /* Uniform jitter of +/- jitter_pct around the interval */
+	TX_PACING_POISSON, /* Exponentially distributed gaps with the interval as mean */
+};
+
+/* One rate step of a TX session */
+struct tx_step {
+	uint32_t interval_us; /* 0: send as fast as the stack accepts */
+	uint32_t duration_ms;
+	uint16_t tag; /* Carried by every frame of the step, 0 outside throughput mode */
+};
+
+/* Absolute-deadline TX pacer */
+struct tx_pacer {
+	struct k_sem cancel_sem;
+	int64_t start_ticks;
+	uint64_t next_us; /* Next deadline relative to start_ticks */
+	uint32_t interval_us;
+	uint8_t jitter_pct;
+	enum tx_pacing_mode mode;
+	uint32_t overruns; /* Deadlines missed by more than one interval */
+};
+
+/**
+ * @brief Initialize a pacer and start its schedule at the current time
+ *
+ * @param pacer Pacer to initialize
+ * @param interval_us Mean interval between deadlines in microseconds
+ * @param mode Pacing mode
+ * @param jitter_pct Jitter in percent of the interval, only used in TX_PACING_JITTER
+ */
+void tx_pacer_init(struct tx_pacer *pacer, uint32_t interval_us, enum tx_pacing_mode mode,
+		   uint8_t jitter_pct);
+
+/**
+ * @brief Sleep until the next deadline of the schedule
+ *
+ * Deadlines are absolute so processing time and tick rounding do not accumulate.
+ * If the caller falls behind by more than one interval the schedule is re-anchored
+ * to the current time instead of sending a catch-up burst. With a zero interval
+ * the pacer only yields, so the caller runs open loop.
+ *
+ * @param pacer Pacer to wait on
+ * @return 0 when the deadline is reached, -ECANCELED if tx_pacer_cancel() was called
+ */
+int tx_pacer_wait(struct tx_pacer *pacer);
+
+/**
+ * @brief Get the schedule of a TX session step
+ *
+ * A plain latency test is a single step at the configured interval. The
+ * throughput benchmark is either one open-loop step or
+ * CONFIG_WIFI_LATENCY_TEST_THROUGHPUT_STEPS steps of increasing rate.
+ *
+ * @param idx Step index, starting at 0
+ * @param params Runtime parameters providing the interval, duration and burst length
+ * @param step Filled with the step schedule
+ * @return 0 on success, -ENOENT if idx is past the last step
+ */
+int tx_pacer_get_step(uint32_t idx, const struct test_params *params, struct tx_step *step);
+
+/**
+ * @brief Wake up a waiting pacer immediately and make it return -ECANCELED
+ *
+ * Safe to call from any thread or ISR.
+ *
+ * @param pacer Pacer to cancel
+ */
+void tx_pacer_cancel(struct tx_pacer *pacer);
+
+#endif /* PACING_UTILS_H */
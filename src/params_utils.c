@@ -0,0 +1,409 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/shell/shell.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "pacing_utils.h"
+#include "params_utils.h"
+
+LOG_MODULE_REGISTER(params_utils, CONFIG_LOG_DEFAULT_LEVEL);
+
+#define PARAMS_SETTINGS_ROOT "latency"
+#define PARAMS_SETTINGS_KEY  "params"
+#define PARAMS_SETTINGS_NAME PARAMS_SETTINGS_ROOT "/" PARAMS_SETTINGS_KEY
+#define PARAMS_STORE_VERSION 1
+
+#define PARAMS_MAX_BURST_LEN 64
+#define PARAMS_MAX_CHANNEL   233
+
+/* Stored blob, the version discards data written by an older layout */
+struct params_store {
+	uint8_t version;
+	struct test_params params;
+};
+
+static struct test_params current_params;
+static struct k_spinlock params_lock;
+
+static void params_defaults(struct test_params *params)
+{
+	memset(params, 0, sizeof(*params));
+	params->interval_us = TX_PACER_DEFAULT_INTERVAL_US;
+	params->duration_ms = CONFIG_WIFI_LATENCY_TEST_DURATION_MS;
+	params->payload_size = CONFIG_WIFI_LATENCY_TEST_PAYLOAD_SIZE;
+	params->burst_len = CONFIG_WIFI_LATENCY_TEST_BURST_LEN;
+#ifdef CONFIG_RAW_TX_DEV_RATE_VALUE
+	params->raw_rate = CONFIG_RAW_TX_DEV_RATE_VALUE;
+	params->raw_rate_flags = CONFIG_RAW_TX_DEV_RATE_FLAGS;
+	params->raw_queue = CONFIG_RAW_TX_DEV_QUEUE_NUM;
+#endif
+#if defined(CONFIG_RAW_TX_DEV_CHANNEL)
+	params->channel = CONFIG_RAW_TX_DEV_CHANNEL;
+#elif defined(CONFIG_RAW_RX_DEV_MODE_MONITOR_CHANNEL)
+	params->channel = CONFIG_RAW_RX_DEV_MODE_MONITOR_CHANNEL;
+#endif
+#ifdef CONFIG_UDP_TX_DEV_TARGET_IP
+	strncpy(params->target_ip, CONFIG_UDP_TX_DEV_TARGET_IP, sizeof(params->target_ip) - 1);
+#endif
+}
+
+static int params_validate(const struct test_params *params)
+{
+	struct in_addr addr;
+
+	if (params->duration_ms == 0 ||
+	    params->payload_size > CONFIG_WIFI_LATENCY_TEST_PAYLOAD_SIZE ||
+	    params->burst_len == 0 || params->burst_len > PARAMS_MAX_BURST_LEN ||
+	    params->raw_rate_flags > 4 || params->raw_queue > 4 ||
+	    params->channel > PARAMS_MAX_CHANNEL) {
+		return -EINVAL;
+	}
+
+	if (params->target_ip[0] != '\0' &&
+	    (memchr(params->target_ip, '\0', sizeof(params->target_ip)) == NULL ||
+	     net_addr_pton(AF_INET, params->target_ip, &addr) != 0)) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+#if IS_ENABLED(CONFIG_SETTINGS)
+static int params_settings_set(const char *name, size_t len, settings_read_cb read_cb,
+			       void *cb_arg)
+{
+	struct params_store store;
+	const char *next;
+	int ret;
+
+	if (!settings_name_steq(name, PARAMS_SETTINGS_KEY, &next) || next) {
+		return -ENOENT;
+	}
+
+	if (len != sizeof(store)) {
+		LOG_WRN("Ignoring stored parameters of size %zu", len);
+		return 0;
+	}
+
+	ret = read_cb(cb_arg, &store, sizeof(store));
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (store.version != PARAMS_STORE_VERSION || params_validate(&store.params)) {
+		LOG_WRN("Ignoring invalid stored parameters");
+		return 0;
+	}
+
+	current_params = store.params;
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(latency_params, PARAMS_SETTINGS_ROOT, NULL, params_settings_set,
+			       NULL, NULL);
+#endif /* CONFIG_SETTINGS */
+
+int params_init(void)
+{
+	params_defaults(&current_params);
+
+#if IS_ENABLED(CONFIG_SETTINGS)
+	int ret;
+
+	ret = settings_subsys_init();
+	if (ret) {
+		LOG_ERR("Failed to initialize settings: %d", ret);
+		return ret;
+	}
+
+	ret = settings_load_subtree(PARAMS_SETTINGS_ROOT);
+	if (ret) {
+		LOG_ERR("Failed to load stored parameters: %d", ret);
+		return ret;
+	}
+#endif
+
+	LOG_INF("Test parameters: interval %u us, duration %u ms, payload %u, burst %u",
+		current_params.interval_us, current_params.duration_ms,
+		current_params.payload_size, current_params.burst_len);
+	return 0;
+}
+
+void params_get(struct test_params *params)
+{
+	k_spinlock_key_t key = k_spin_lock(&params_lock);
+
+	*params = current_params;
+
+	k_spin_unlock(&params_lock, key);
+}
+
+int params_set(const struct test_params *params, bool persist)
+{
+	k_spinlock_key_t key;
+	int ret;
+
+	ret = params_validate(params);
+	if (ret) {
+		return ret;
+	}
+
+	key = k_spin_lock(&params_lock);
+	current_params = *params;
+	k_spin_unlock(&params_lock, key);
+
+#if IS_ENABLED(CONFIG_SETTINGS)
+	if (persist) {
+		struct params_store store = {
+			.version = PARAMS_STORE_VERSION,
+			.params = *params,
+		};
+
+		ret = settings_save_one(PARAMS_SETTINGS_NAME, &store, sizeof(store));
+		if (ret) {
+			LOG_ERR("Failed to store parameters: %d", ret);
+			return ret;
+		}
+	}
+#else
+	if (persist) {
+		return -ENOTSUP;
+	}
+#endif
+
+	return 0;
+}
+
+int params_reset(void)
+{
+	struct test_params params;
+
+	params_defaults(&params);
+	params_set(&params, false);
+
+#if IS_ENABLED(CONFIG_SETTINGS)
+	return settings_delete(PARAMS_SETTINGS_NAME);
+#else
+	return 0;
+#endif
+}
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_SHELL)
+/* Numeric "--name value" options of the start and set commands */
+struct params_opt {
+	const char *name;
+	size_t offset;
+	uint8_t size;
+};
+
+#define PARAMS_OPT(_name, _field)                                                                  \
+	{                                                                                          \
+		.name = _name, .offset = offsetof(struct test_params, _field),                   \
+		.size = sizeof(((struct test_params *)0)->_field),                                 \
+	}
+
+static const struct params_opt params_opts[] = {
+	PARAMS_OPT("--interval-us", interval_us), PARAMS_OPT("--duration-ms", duration_ms),
+	PARAMS_OPT("--size", payload_size),       PARAMS_OPT("--burst", burst_len),
+	PARAMS_OPT("--rate", raw_rate),           PARAMS_OPT("--rate-flags", raw_rate_flags),
+	PARAMS_OPT("--queue", raw_queue),         PARAMS_OPT("--channel", channel),
+};
+
+static void params_print(const struct shell *sh, const struct test_params *params)
+{
+	shell_print(sh, "interval-us %u", params->interval_us);
+	shell_print(sh, "duration-ms %u", params->duration_ms);
+	shell_print(sh, "size        %u (max %u)", params->payload_size,
+		    CONFIG_WIFI_LATENCY_TEST_PAYLOAD_SIZE);
+	shell_print(sh, "burst       %u", params->burst_len);
+	shell_print(sh, "rate        %u", params->raw_rate);
+	shell_print(sh, "rate-flags  %u", params->raw_rate_flags);
+	shell_print(sh, "queue       %u", params->raw_queue);
+	shell_print(sh, "channel     %u", params->channel);
+	shell_print(sh, "target-ip   %s", params->target_ip);
+}
+
+static int params_opt_store(struct test_params *params, const struct params_opt *opt,
+			    unsigned long value)
+{
+	uint8_t *field = (uint8_t *)params + opt->offset;
+
+	if (opt->size < sizeof(value) && value >= BIT64(8 * opt->size)) {
+		return -ERANGE;
+	}
+
+	switch (opt->size) {
+	case sizeof(uint8_t):
+		*field = value;
+		break;
+	case sizeof(uint16_t):
+		UNALIGNED_PUT((uint16_t)value, (uint16_t *)field);
+		break;
+	default:
+		UNALIGNED_PUT((uint32_t)value, (uint32_t *)field);
+		break;
+	}
+	return 0;
+}
+
+/* Apply "--name value" pairs on top of the current parameters */
+static int params_parse(const struct shell *sh, size_t argc, char **argv,
+			struct test_params *params, bool *persist)
+{
+	params_get(params);
+	*persist = false;
+
+	for (size_t i = 1; i < argc; i++) {
+		const char *name = argv[i];
+		const char *value;
+		unsigned long num;
+		int err = 0;
+		size_t j;
+
+		if (strcmp(name, "--save") == 0) {
+			*persist = true;
+			continue;
+		}
+
+		if (i + 1 >= argc) {
+			shell_error(sh, "Missing value for %s", name);
+			return -EINVAL;
+		}
+		value = argv[++i];
+
+		if (strcmp(name, "--target-ip") == 0) {
+			if (strlen(value) >= sizeof(params->target_ip)) {
+				shell_error(sh, "Invalid IPv4 address: %s", value);
+				return -EINVAL;
+			}
+			strcpy(params->target_ip, value);
+			continue;
+		}
+
+		for (j = 0; j < ARRAY_SIZE(params_opts); j++) {
+			if (strcmp(name, params_opts[j].name) == 0) {
+				break;
+			}
+		}
+		if (j == ARRAY_SIZE(params_opts)) {
+			shell_error(sh, "Unknown option %s", name);
+			return -EINVAL;
+		}
+
+		num = shell_strtoul(value, 0, &err);
+		if (err || params_opt_store(params, &params_opts[j], num)) {
+			shell_error(sh, "Invalid value for %s: %s", name, value);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+static int params_apply(const struct shell *sh, size_t argc, char **argv)
+{
+	struct test_params params;
+	bool persist;
+	int ret;
+
+	ret = params_parse(sh, argc, argv, &params, &persist);
+	if (ret) {
+		return ret;
+	}
+
+	ret = params_set(&params, persist);
+	if (ret) {
+		shell_error(sh, "Failed to apply parameters: %d", ret);
+		return ret;
+	}
+	return 0;
+}
+
+static int cmd_latency_show(const struct shell *sh, size_t argc, char **argv)
+{
+	struct test_params params;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	params_get(&params);
+	params_print(sh, &params);
+	return 0;
+}
+
+static int cmd_latency_set(const struct shell *sh, size_t argc, char **argv)
+{
+	return params_apply(sh, argc, argv);
+}
+
+static int cmd_latency_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	int ret;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	ret = params_reset();
+	if (ret && ret != -ENOENT) {
+		shell_error(sh, "Failed to delete stored parameters: %d", ret);
+		return ret;
+	}
+	shell_print(sh, "Parameters reset to Kconfig defaults");
+	return 0;
+}
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX)
+static int cmd_latency_start(const struct shell *sh, size_t argc, char **argv)
+{
+	int ret;
+
+	ret = params_apply(sh, argc, argv);
+	if (ret) {
+		return ret;
+	}
+
+	latency_test_start();
+	return 0;
+}
+
+static int cmd_latency_stop(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(sh);
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	latency_test_stop();
+	return 0;
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX */
+
+#define PARAMS_OPTS_HELP                                                                           \
+	"[--interval-us <us>] [--duration-ms <ms>] [--size <bytes>] [--burst <n>]\n"             \
+	"[--rate <value>] [--rate-flags <flags>] [--queue <q>] [--channel <ch>]\n"               \
+	"[--target-ip <addr>] [--save]"
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+	latency_cmds,
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX)
+	SHELL_CMD(start, NULL, "Apply parameters and (re)start the TX session\n" PARAMS_OPTS_HELP,
+		  cmd_latency_start),
+	SHELL_CMD_ARG(stop, NULL, "Stop the TX session", cmd_latency_stop, 1, 0),
+#endif
+	SHELL_CMD(set, NULL, "Change parameters for the next session\n" PARAMS_OPTS_HELP,
+		  cmd_latency_set),
+	SHELL_CMD_ARG(show, NULL, "Show the current parameters", cmd_latency_show, 1, 0),
+	SHELL_CMD_ARG(reset, NULL, "Restore and persist the Kconfig defaults", cmd_latency_reset,
+		      1, 0),
+	SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(latency, &latency_cmds, "Wi-Fi latency test control", NULL);
+#endif /* CONFIG_WIFI_LATENCY_TEST_SHELL */
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef PARAMS_UTILS_H
+#define PARAMS_UTILS_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/net_ip.h>
+
+/* Runtime test parameters. Defaults come from Kconfig; values changed from the
+ * shell are persisted with the settings subsystem and take effect at the next
+ * TX session.
+ */
+struct test_params {
+	uint32_t interval_us;
+	uint32_t duration_ms;
+	uint16_t payload_size; /* Padding bytes, at most CONFIG_WIFI_LATENCY_TEST_PAYLOAD_SIZE */
+	uint8_t burst_len;
+	uint8_t raw_rate;       /* Raw TX rate value, see CONFIG_RAW_TX_DEV_RATE_VALUE */
+	uint8_t raw_rate_flags; /* Raw TX rate flags, see CONFIG_RAW_TX_DEV_RATE_FLAGS */
+	uint8_t raw_queue;      /* Raw TX queue, see CONFIG_RAW_TX_DEV_QUEUE_NUM */
+	uint8_t channel;        /* Raw TX/monitor channel, 0 to keep the current one */
+	char target_ip[NET_IPV4_ADDR_LEN];
+};
+
+/**
+ * @brief Load the stored parameters, falling back to the Kconfig defaults
+ *
+ * @return 0 on success, negative error code on failure
+ */
+int params_init(void);
+
+/**
+ * @brief Get a copy of the current parameters
+ *
+ * @param params Filled with the current parameters
+ */
+void params_get(struct test_params *params);
+
+/**
+ * @brief Validate and apply new parameters
+ *
+ * @param params New parameters
+ * @param persist Also write them to the settings storage
+ * @return 0 on success, -EINVAL if a value is out of range, or a settings error
+ */
+int params_set(const struct test_params *params, bool persist);
+
+/**
+ * @brief Restore the Kconfig defaults and delete the stored parameters
+ *
+ * @return 0 on success, negative error code on failure
+ */
+int params_reset(void);
+
+/* Session control provided by the application for the shell commands */
+
+/**
+ * @brief Stop the running TX session, if any, and start a new one
+ */
+void latency_test_start(void);
+
+/**
+ * @brief Stop the running TX session, if any
+ */
+void latency_test_stop(void);
+
+#endif /* PARAMS_UTILS_H */
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/fdtable.h>
+#include <zephyr/sys/sys_heap.h>
+
+#include "pool_utils.h"
+
+LOG_MODULE_REGISTER(pool_utils, CONFIG_LOG_DEFAULT_LEVEL);
+
+#define POOL_INTERVAL K_MSEC(CONFIG_WIFI_LATENCY_TEST_POOL_MONITOR_INTERVAL_MS)
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_POOL_MONITOR_HEAP)
+/* Defined by the nRF70 driver OS shim, holds the frames queued for TX and RX */
+extern struct k_heap wifi_drv_data_mem_pool;
+#endif
+
+enum pool_id {
+	POOL_PKT_RX,
+	POOL_PKT_TX,
+	POOL_BUF_RX,
+	POOL_BUF_TX,
+	POOL_COUNT,
+};
+
+static const char *const pool_names[POOL_COUNT] = {"pkt rx", "pkt tx", "buf rx", "buf tx"};
+
+/* One report window, written by the sampling work and read by the reporter */
+struct pool_window {
+	uint32_t min_free[POOL_COUNT];
+	/* Samples that found the pool empty */
+	uint32_t empty[POOL_COUNT];
+	uint32_t sock_max_bytes;
+	uint32_t samples;
+};
+
+static void pool_sample_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(pool_sample_work, pool_sample_work_handler);
+
+static struct k_mem_slab *pool_pkt_slab[2];
+static struct net_buf_pool *pool_buf[2];
+static struct pool_window pool_window;
+static struct k_spinlock pool_lock;
+static int pool_socket = -1;
+/* Cleared by pool_monitor_stop(), a running handler then does not re-arm */
+static atomic_t pool_running;
+
+static void pool_window_reset(void)
+{
+	for (int i = 0; i < POOL_COUNT; i++) {
+		pool_window.min_free[i] = UINT32_MAX;
+		pool_window.empty[i] = 0;
+	}
+	pool_window.sock_max_bytes = 0;
+	pool_window.samples = 0;
+}
+
+static uint32_t pool_free(enum pool_id id)
+{
+	switch (id) {
+	case POOL_PKT_RX:
+	case POOL_PKT_TX:
+		return k_mem_slab_num_free_get(pool_pkt_slab[id - POOL_PKT_RX]);
+	default:
+		return atomic_get(&pool_buf[id - POOL_BUF_RX]->avail_count);
+	}
+}
+
+static uint32_t pool_size(enum pool_id id)
+{
+	switch (id) {
+	case POOL_PKT_RX:
+	case POOL_PKT_TX:
+		return pool_pkt_slab[id - POOL_PKT_RX]->info.num_blocks;
+	default:
+		return pool_buf[id - POOL_BUF_RX]->buf_count;
+	}
+}
+
+static void pool_sample_work_handler(struct k_work *work)
+{
+	int sock_bytes = 0;
+	k_spinlock_key_t key;
+
+	/* FIONREAD reports the bytes waiting in the socket receive queue */
+	if (pool_socket >= 0 && zsock_ioctl(pool_socket, ZFD_IOCTL_FIONREAD, &sock_bytes) < 0) {
+		sock_bytes = 0;
+	}
+
+	key = k_spin_lock(&pool_lock);
+	for (int i = 0; i < POOL_COUNT; i++) {
+		uint32_t free = pool_free(i);
+
+		pool_window.min_free[i] = MIN(pool_window.min_free[i], free);
+		if (!free) {
+			pool_window.empty[i]++;
+		}
+	}
+	pool_window.sock_max_bytes = MAX(pool_window.sock_max_bytes, (uint32_t)sock_bytes);
+	pool_window.samples++;
+	k_spin_unlock(&pool_lock, key);
+
+	if (atomic_get(&pool_running)) {
+		k_work_schedule(&pool_sample_work, POOL_INTERVAL);
+	}
+}
+
+void pool_monitor_start(void)
+{
+	k_spinlock_key_t key;
+
+	net_pkt_get_info(&pool_pkt_slab[0], &pool_pkt_slab[1], &pool_buf[0], &pool_buf[1]);
+
+	key = k_spin_lock(&pool_lock);
+	pool_window_reset();
+	k_spin_unlock(&pool_lock, key);
+
+	atomic_set(&pool_running, 1);
+	k_work_schedule(&pool_sample_work, K_NO_WAIT);
+}
+
+void pool_monitor_stop(void)
+{
+	atomic_set(&pool_running, 0);
+	k_work_cancel_delayable(&pool_sample_work);
+}
+
+void pool_monitor_set_socket(int socket)
+{
+	pool_socket = socket;
+}
+
+void pool_monitor_print(void)
+{
+	struct pool_window window;
+	k_spinlock_key_t key;
+
+	if (!pool_pkt_slab[0]) {
+		return;
+	}
+
+	key = k_spin_lock(&pool_lock);
+	window = pool_window;
+	pool_window_reset();
+	k_spin_unlock(&pool_lock, key);
+
+	if (!window.samples) {
+		return;
+	}
+
+	for (int i = 0; i < POOL_COUNT; i++) {
+		uint32_t size = pool_size(i);
+
+		LOG_INF("[pool] %s: %u/%u used at peak, empty in %u of %u samples", pool_names[i],
+			size - window.min_free[i], size, window.empty[i], window.samples);
+	}
+	if (pool_socket >= 0) {
+		LOG_INF("[pool] socket rx queue: max %u bytes", window.sock_max_bytes);
+	}
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_POOL_MONITOR_HEAP)
+	struct sys_memory_stats heap;
+
+	/* The heap tracks its own high-water mark, no sample can miss the peak */
+	if (sys_heap_runtime_stats_get(&wifi_drv_data_mem_pool.heap, &heap) == 0) {
+		LOG_INF("[pool] nrf70 data heap: %zu/%zu bytes used, max %zu",
+			heap.allocated_bytes, heap.allocated_bytes + heap.free_bytes,
+			heap.max_allocated_bytes);
+		sys_heap_runtime_stats_reset_max(&wifi_drv_data_mem_pool.heap);
+	}
+#endif
+}
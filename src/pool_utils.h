@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef POOL_UTILS_H
+#define POOL_UTILS_H
+
+#include <zephyr/kernel.h>
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_POOL_MONITOR)
+/**
+ * @brief Start sampling the network buffer pools
+ *
+ * Samples the net_pkt slabs, the net_buf data pools, the nRF70 data heap and
+ * the watched socket every CONFIG_WIFI_LATENCY_TEST_POOL_MONITOR_INTERVAL_MS
+ * from the system workqueue. When already running, only starts a new report
+ * window, e.g. at the beginning of a TX session.
+ */
+void pool_monitor_start(void);
+
+/**
+ * @brief Stop sampling, e.g. at the end of a TX session
+ *
+ * The current window stays available to pool_monitor_print().
+ */
+void pool_monitor_stop(void);
+
+/**
+ * @brief Watch the receive queue of a socket
+ *
+ * Only one socket is watched, a later call replaces it.
+ *
+ * @param socket Socket descriptor, -1 to stop watching
+ */
+void pool_monitor_set_socket(int socket);
+
+/**
+ * @brief Log the pool usage since the last report and start a new window
+ *
+ * Called with every latency summary, so the lowest free counts line up with
+ * the latency tails of the same window.
+ */
+void pool_monitor_print(void);
+#else
+static inline void pool_monitor_start(void)
+{
+}
+
+static inline void pool_monitor_stop(void)
+{
+}
+
+static inline void pool_monitor_set_socket(int socket)
+{
+}
+
+static inline void pool_monitor_print(void)
+{
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_POOL_MONITOR */
+
+#endif /* POOL_UTILS_H */
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_mgmt.h>
+#include <zephyr/net/wifi_mgmt.h>
+#include <zephyr/sys/atomic.h>
+
+#include "ps_utils.h"
+
+LOG_MODULE_REGISTER(ps_utils, CONFIG_LOG_DEFAULT_LEVEL);
+
+/* Written from the net_mgmt thread, read by the session reports */
+static atomic_t ps_twt_active;
+
+static int ps_set(struct wifi_ps_params *params)
+{
+	struct net_if *iface = net_if_get_first_wifi();
+	int ret;
+
+	if (!iface) {
+		LOG_ERR("Failed to get Wi-Fi iface");
+		return -ENODEV;
+	}
+
+	ret = net_mgmt(NET_REQUEST_WIFI_PS, iface, params, sizeof(*params));
+	if (ret) {
+		LOG_ERR("Power save parameter %d failed: %d (reason %d)", params->type, ret,
+			params->fail_reason);
+	}
+
+	return ret;
+}
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_TWT)
+#define PS_TWT_EVENT_MASK (NET_EVENT_WIFI_TWT | NET_EVENT_WIFI_TWT_SLEEP_STATE)
+#define PS_TWT_FLOW_ID    1
+
+static struct net_mgmt_event_callback ps_twt_cb;
+/* Service periods seen since the last configuration report */
+static atomic_t ps_twt_wakes;
+
+static void ps_twt_event_handler(struct net_mgmt_event_callback *cb, uint32_t mgmt_event,
+				 struct net_if *iface)
+{
+	const struct wifi_twt_params *resp;
+
+	if (mgmt_event == NET_EVENT_WIFI_TWT_SLEEP_STATE) {
+		const int *state = (const int *)cb->info;
+
+		if (*state == WIFI_TWT_STATE_AWAKE) {
+			atomic_inc(&ps_twt_wakes);
+		}
+		return;
+	}
+
+	resp = (const struct wifi_twt_params *)cb->info;
+	if (resp->operation == WIFI_TWT_TEARDOWN) {
+		LOG_INF("TWT flow %u torn down", resp->flow_id);
+		atomic_set(&ps_twt_active, 0);
+		return;
+	}
+
+	if (resp->resp_status != WIFI_TWT_RESP_RECEIVED) {
+		LOG_WRN("No TWT response from the AP");
+		return;
+	}
+	if (resp->setup_cmd != WIFI_TWT_SETUP_CMD_ACCEPT) {
+		LOG_WRN("TWT setup rejected by the AP: command %d", resp->setup_cmd);
+		return;
+	}
+
+	/* The AP may have adjusted the schedule, the accepted one is what gets measured */
+	atomic_set(&ps_twt_active, 1);
+	LOG_INF("TWT flow %u accepted: interval %llu us, wake %u us", resp->flow_id,
+		resp->setup.twt_interval, resp->setup.twt_wake_interval);
+}
+
+/* The setup request is a driver round trip, keep it out of the connect callback */
+static void ps_twt_setup_work_handler(struct k_work *work)
+{
+	struct net_if *iface = net_if_get_first_wifi();
+	struct wifi_twt_params params = {
+		.operation = WIFI_TWT_SETUP,
+		.negotiation_type = WIFI_TWT_INDIVIDUAL,
+		.setup_cmd = WIFI_TWT_SETUP_CMD_REQUEST,
+		.dialog_token = 1,
+		.flow_id = PS_TWT_FLOW_ID,
+		.setup = {
+			.twt_interval = CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_TWT_INTERVAL_US,
+			.twt_wake_interval = CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_TWT_WAKE_US,
+			.responder = false,
+			.implicit = true,
+			.trigger = IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_TWT_TRIGGER),
+			.announce = IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_TWT_ANNOUNCED),
+		},
+	};
+	int ret;
+
+	ARG_UNUSED(work);
+
+	if (!iface || atomic_get(&ps_twt_active)) {
+		return;
+	}
+
+	ret = net_mgmt(NET_REQUEST_WIFI_TWT, iface, &params, sizeof(params));
+	if (ret) {
+		LOG_ERR("TWT setup request failed: %d (reason %d)", ret, params.fail_reason);
+		return;
+	}
+	LOG_INF("TWT setup requested: interval %u us, wake %u us",
+		CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_TWT_INTERVAL_US,
+		CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_TWT_WAKE_US);
+}
+
+static K_WORK_DEFINE(ps_twt_setup_work, ps_twt_setup_work_handler);
+#endif /* CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_TWT */
+
+int ps_init(void)
+{
+	struct wifi_ps_params params = {0};
+	int ret;
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_TWT)
+	net_mgmt_init_event_callback(&ps_twt_cb, ps_twt_event_handler, PS_TWT_EVENT_MASK);
+	net_mgmt_add_event_callback(&ps_twt_cb);
+#endif
+
+	params.type = WIFI_PS_PARAM_MODE;
+	params.mode = WIFI_PS_MODE_LEGACY;
+	ret = ps_set(&params);
+	if (ret) {
+		return ret;
+	}
+
+	params.type = WIFI_PS_PARAM_WAKEUP_MODE;
+	params.wakeup_mode = IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_LEGACY)
+				     ? WIFI_PS_WAKEUP_MODE_LISTEN_INTERVAL
+				     : WIFI_PS_WAKEUP_MODE_DTIM;
+	ret = ps_set(&params);
+	if (ret) {
+		return ret;
+	}
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_LEGACY)
+	params.type = WIFI_PS_PARAM_LISTEN_INTERVAL;
+	params.listen_interval = CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_LISTEN_INTERVAL;
+	ret = ps_set(&params);
+	if (ret) {
+		return ret;
+	}
+#endif
+
+	params.type = WIFI_PS_PARAM_TIMEOUT;
+	params.timeout_ms = CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_TIMEOUT_MS;
+	ret = ps_set(&params);
+	if (ret) {
+		return ret;
+	}
+
+	/* TWT agreements are only negotiated with power save enabled */
+	params.type = WIFI_PS_PARAM_STATE;
+	params.enabled = WIFI_PS_ENABLED;
+	ret = ps_set(&params);
+	if (ret) {
+		return ret;
+	}
+
+	ps_print_config();
+	return 0;
+}
+
+void ps_link_up(void)
+{
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_TWT)
+	k_work_submit(&ps_twt_setup_work);
+#endif
+}
+
+void ps_link_down(void)
+{
+	/* The AP drops the agreement with the association */
+	atomic_set(&ps_twt_active, 0);
+}
+
+void ps_print_config(void)
+{
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_LEGACY)
+	LOG_INF("Power save: legacy, listen interval %u, timeout %u ms",
+		CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_LISTEN_INTERVAL,
+		CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_TIMEOUT_MS);
+#elif IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_DTIM)
+	LOG_INF("Power save: legacy, DTIM wakeup, timeout %u ms",
+		CONFIG_WIFI_LATENCY_TEST_POWER_SAVE_TIMEOUT_MS);
+#else
+	LOG_INF("Power save: TWT %s, %u service periods since the last report",
+		atomic_get(&ps_twt_active) ? "active" : "not negotiated",
+		(uint32_t)atomic_set(&ps_twt_wakes, 0));
+#endif
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef PS_UTILS_H
+#define PS_UTILS_H
+
+#include <zephyr/kernel.h>
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_POWER_SAVE)
+/**
+ * @brief Configure station power save before connecting
+ *
+ * Sets the power save mode, wakeup mode, listen interval and inactivity
+ * timeout. The listen interval is announced in the association request, so
+ * this must run before the first connection.
+ *
+ * @return 0 on success, negative error code on failure
+ */
+int ps_init(void);
+
+/**
+ * @brief Start the power save schedule that needs an association
+ *
+ * Requests the individual TWT agreement in TWT mode, no-op otherwise.
+ * The request runs from the system work queue, so this is safe to call
+ * from the connect result event callback.
+ */
+void ps_link_up(void);
+
+/**
+ * @brief Forget the TWT agreement after the link was lost
+ */
+void ps_link_down(void);
+
+/**
+ * @brief Log the active power save configuration
+ *
+ * Logged at every session start so latency results and the PPK2 current
+ * capture of the same run can be matched to the configuration.
+ */
+void ps_print_config(void);
+#else
+static inline void ps_link_up(void)
+{
+}
+
+static inline void ps_link_down(void)
+{
+}
+
+static inline void ps_print_config(void)
+{
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_POWER_SAVE */
+
+#endif /* PS_UTILS_H */
@@ -9,30 +9,60 @@
 #include <zephyr/net/wifi_mgmt.h>
 #include <zephyr/net/net_mgmt.h>
 #include <zephyr/net/net_if.h>
+#include <zephyr/net/net_ip.h>
 #include <zephyr/net/socket.h>
 #include <zephyr/net/ethernet.h>
+#include <zephyr/net/net_pkt_filter.h>
 #include <zephyr/random/random.h>
 #include <zephyr/posix/arpa/inet.h>
+#include <zephyr/sys/byteorder.h>
+#include <stddef.h>
 #include <string.h>
 
 #include "raw_utils.h"
 #include "wifi_utils.h"
+#include "boot_utils.h"
+#include "hop_utils.h"
 #include "led_utils.h"
 #include "net_event_mgmt_utils.h"
+#include "params_utils.h"
+#include "stats_utils.h"
+#include "sweep_utils.h"
+#include "trace_utils.h"
 
 LOG_MODULE_REGISTER(raw_utils, CONFIG_LOG_DEFAULT_LEVEL);
 
-#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_PACKET_TYPE_RAW)
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRANSPORT_RAW)
 #if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX)
 /* Constants */
 #define NRF_WIFI_MAGIC_NUM_RAWTX        0x12345678
 #define IEEE80211_SEQ_CTRL_SEQ_NUM_MASK 0xFFF0
 #define IEEE80211_SEQ_NUMBER_INC        BIT(4)
+#define RAW_TX_FRAME_BUF_LEN                                                                       \
+	(sizeof(struct raw_tx_pkt_header) + sizeof(struct beacon_frame))
 
 /* Global variables */
 static int raw_sockfd = -1;
 static struct sockaddr_ll sa;
 
+/* Runtime TX settings, applied by raw_tx_configure() before each session */
+static uint8_t raw_tx_rate = CONFIG_RAW_TX_DEV_RATE_VALUE;
+static uint8_t raw_tx_rate_flags = CONFIG_RAW_TX_DEV_RATE_FLAGS;
+static uint8_t raw_tx_queue = CONFIG_RAW_TX_DEV_QUEUE_NUM;
+/* Beacon length on air, the padding tail is trimmed below its compile-time size */
+static size_t raw_tx_frame_len = sizeof(struct beacon_frame);
+#ifdef CONFIG_RAW_TX_DEV_MODE_NON_CONNECTED
+static uint8_t raw_tx_channel = CONFIG_RAW_TX_DEV_CHANNEL;
+#endif
+
+#if IS_ENABLED(CONFIG_RAW_TX_DEV_STATIC_FRAME_BUF)
+/* Header + frame built once; sendto() copies it into a net_pkt before returning,
+ * so a single buffer is enough for back-to-back transmissions.
+ */
+static uint8_t raw_tx_frame_buf[RAW_TX_FRAME_BUF_LEN] __aligned(4);
+static bool raw_tx_frame_ready;
+#endif
+
 /* Test beacon frame template with identifiable payload */
 static struct beacon_frame test_beacon_frame = {
 	.frame_control = htons(0x8000), /* Beacon frame */
@@ -63,7 +93,18 @@ static struct beacon_frame test_beacon_frame = {
 		    0X00, 0XFA, 0XFF, 0XFA, 0XFF, 0X61, 0X1C, 0XC7, 0X71, 0XFF, 0X07, 0X24, 0XF0,
 		    0X3F, 0X00, 0X81, 0XFC, 0XFF, 0XDD, 0X18, 0X00, 0X50, 0XF2, 0X02, 0X01, 0X01,
 		    0X01, 0X00, 0X03, 0XA4, 0X00, 0X00, 0X27, 0XA4, 0X00, 0X00, 0X42, 0X43, 0X5E,
-		    0X00, 0X62, 0X32, 0X2F, 0X00}};
+		    0X00, 0X62, 0X32, 0X2F, 0X00,
+
+		    /* Vendor specific IE: latency test info, patched per packet */
+		    RAW_TEST_IE_ID, RAW_TEST_IE_LEN, RAW_TEST_IE_OUI_0, RAW_TEST_IE_OUI_1,
+		    RAW_TEST_IE_OUI_2, RAW_TEST_IE_OUI_TYPE}};
+
+BUILD_ASSERT(RAW_TEST_IE_OFFSET + sizeof(struct raw_test_ie) <= sizeof(test_beacon_frame.payload),
+	     "Latency test IE does not fit in the beacon payload");
+#ifdef CONFIG_NRF70_TX_MAX_DATA_SIZE
+BUILD_ASSERT(RAW_TX_FRAME_BUF_LEN <= CONFIG_NRF70_TX_MAX_DATA_SIZE,
+	     "WIFI_LATENCY_TEST_PAYLOAD_SIZE exceeds NRF70_TX_MAX_DATA_SIZE");
+#endif
 
 /* Setup raw packet socket */
 int raw_tx_socket_init(void)
@@ -103,13 +144,41 @@ int raw_tx_socket_init(void)
 static void fill_raw_tx_pkt_hdr(struct raw_tx_pkt_header *raw_tx_pkt)
 {
 	raw_tx_pkt->magic_num = NRF_WIFI_MAGIC_NUM_RAWTX;
-	raw_tx_pkt->data_rate = CONFIG_RAW_TX_DEV_RATE_VALUE;
-	raw_tx_pkt->packet_length = sizeof(test_beacon_frame);
-	raw_tx_pkt->tx_mode = CONFIG_RAW_TX_DEV_RATE_FLAGS;
-	raw_tx_pkt->queue = CONFIG_RAW_TX_DEV_QUEUE_NUM;
+	raw_tx_pkt->data_rate = raw_tx_rate;
+	raw_tx_pkt->packet_length = raw_tx_frame_len;
+	raw_tx_pkt->tx_mode = raw_tx_rate_flags;
+	raw_tx_pkt->queue = raw_tx_queue;
 	raw_tx_pkt->raw_tx_flag = 0; /* Reserved for driver */
 }
 
+/* Patch the per-packet fields of an already built frame in place */
+static void raw_tx_patch_frame(struct beacon_frame *frame, struct raw_test_pkt_info *info)
+{
+	struct raw_test_ie *ie = (struct raw_test_ie *)&frame->payload[RAW_TEST_IE_OFFSET];
+
+	/* Beacon timestamp field (first 8 bytes of the body) carries TX uptime in us */
+	sys_put_le64(k_ticks_to_us_floor64(k_uptime_ticks()), frame->payload);
+	frame->seq_ctrl = test_beacon_frame.seq_ctrl;
+	ie->burst_idx = info->burst_idx;
+	ie->burst_len = info->burst_len;
+	sys_put_le16(info->tag, (uint8_t *)&ie->tag);
+
+	/* Sample the TX timestamp last so it is as close to sendto() as possible */
+	sys_put_le32(info->seq, (uint8_t *)&ie->seq);
+	info->tx_cycles = k_cycle_get_64();
+	sys_put_le64(info->tx_cycles, (uint8_t *)&ie->tx_cycles);
+}
+
+#if IS_ENABLED(CONFIG_RAW_TX_DEV_STATIC_FRAME_BUF)
+static void raw_tx_build_frame(void)
+{
+	fill_raw_tx_pkt_hdr((struct raw_tx_pkt_header *)raw_tx_frame_buf);
+	memcpy(raw_tx_frame_buf + sizeof(struct raw_tx_pkt_header), &test_beacon_frame,
+	       sizeof(test_beacon_frame));
+	raw_tx_frame_ready = true;
+}
+#endif
+
 static void increment_seq_control(void)
 {
 	test_beacon_frame.seq_ctrl = (test_beacon_frame.seq_ctrl + IEEE80211_SEQ_NUMBER_INC) &
@@ -150,7 +219,69 @@ int raw_tx_init(void)
 	return 0;
 }
 
-int raw_tx_send_packet(uint32_t packet_num)
+int raw_tx_configure(const struct test_params *params)
+{
+	raw_tx_rate = params->raw_rate;
+	raw_tx_rate_flags = params->raw_rate_flags;
+	raw_tx_queue = params->raw_queue;
+	raw_tx_frame_len = sizeof(struct beacon_frame) -
+			   (CONFIG_WIFI_LATENCY_TEST_PAYLOAD_SIZE - params->payload_size);
+#if IS_ENABLED(CONFIG_RAW_TX_DEV_STATIC_FRAME_BUF)
+	/* The header is part of the prebuilt frame, rebuild it on the next send */
+	raw_tx_frame_ready = false;
+#endif
+
+#ifdef CONFIG_RAW_TX_DEV_MODE_NON_CONNECTED
+	if (params->channel && params->channel != raw_tx_channel) {
+		int ret = wifi_set_channel(params->channel);
+
+		if (ret) {
+			LOG_ERR("Failed to set Wi-Fi channel %u: %d", params->channel, ret);
+			return ret;
+		}
+		raw_tx_channel = params->channel;
+	}
+#endif
+
+	LOG_INF("Raw TX rate %u flags %u queue %u, frame %zu bytes", raw_tx_rate,
+		raw_tx_rate_flags, raw_tx_queue, raw_tx_frame_len);
+	return 0;
+}
+
+#if IS_ENABLED(CONFIG_RAW_TX_DEV_STATIC_FRAME_BUF)
+int raw_tx_send_packet(struct raw_test_pkt_info *info)
+{
+	int ret;
+
+	if (raw_sockfd < 0) {
+		LOG_ERR("Raw socket not initialized");
+		return -ENOTCONN;
+	}
+
+	if (!raw_tx_frame_ready) {
+		raw_tx_build_frame();
+	}
+
+	/* Only the sequence control and timestamp change between packets */
+	raw_tx_patch_frame(
+		(struct beacon_frame *)(raw_tx_frame_buf + sizeof(struct raw_tx_pkt_header)),
+		info);
+
+	/* Send the packet */
+	ret = sendto(raw_sockfd, raw_tx_frame_buf,
+		     sizeof(struct raw_tx_pkt_header) + raw_tx_frame_len, 0,
+		     (struct sockaddr *)&sa, sizeof(sa));
+	if (ret < 0) {
+		LOG_ERR("Failed to send raw packet: %s", strerror(errno));
+		return -errno;
+	}
+	/* Increment sequence control for next packet */
+	increment_seq_control();
+
+	return 0;
+}
+#else
+int raw_tx_send_packet(struct raw_test_pkt_info *info)
 {
 	struct raw_tx_pkt_header packet_hdr;
 	char *test_frame;
@@ -166,7 +297,7 @@ int raw_tx_send_packet(uint32_t packet_num)
 	fill_raw_tx_pkt_hdr(&packet_hdr);
 
 	/* Allocate buffer for header + frame */
-	buf_length = sizeof(struct raw_tx_pkt_header) + sizeof(test_beacon_frame);
+	buf_length = sizeof(struct raw_tx_pkt_header) + raw_tx_frame_len;
 	test_frame = k_malloc(buf_length);
 	if (!test_frame) {
 		LOG_ERR("Failed to allocate transmission buffer");
@@ -178,7 +309,9 @@ int raw_tx_send_packet(uint32_t packet_num)
 	memcpy(test_frame, &packet_hdr, sizeof(struct raw_tx_pkt_header));
 	/* Copy the test beacon frame */
 	memcpy(test_frame + sizeof(struct raw_tx_pkt_header), &test_beacon_frame,
-	       sizeof(test_beacon_frame));
+	       raw_tx_frame_len);
+	raw_tx_patch_frame((struct beacon_frame *)(test_frame + sizeof(struct raw_tx_pkt_header)),
+			   info);
 
 	/* Send the packet */
 	ret = sendto(raw_sockfd, test_frame, buf_length, 0, (struct sockaddr *)&sa, sizeof(sa));
@@ -193,6 +326,7 @@ int raw_tx_send_packet(uint32_t packet_num)
 	k_free(test_frame);
 	return 0;
 }
+#endif /* CONFIG_RAW_TX_DEV_STATIC_FRAME_BUF */
 
 void raw_tx_cleanup(void)
 {
@@ -202,13 +336,97 @@ void raw_tx_cleanup(void)
 	}
 	LOG_INF("Raw TX cleanup complete");
 }
-#endif /* CONFIG_WIFI_LATENCY_TEST_PACKET_TYPE_RAW && CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX */
+
+static int raw_transport_init(struct latency_transport *transport, const struct test_params *params)
+{
+	int ret;
+
+	ret = raw_tx_configure(params);
+	if (ret < 0) {
+		LOG_ERR("Failed to apply raw TX parameters: %d", ret);
+		return ret;
+	}
+
+	return raw_tx_socket_init();
+}
+
+static int raw_transport_send(struct latency_transport *transport, const struct engine_pkt *pkt,
+			      struct engine_sent *sent)
+{
+	struct raw_test_pkt_info info = {
+		.seq = pkt->seq,
+		.burst_idx = pkt->burst_idx,
+		.burst_len = pkt->burst_len,
+		.tag = pkt->tag,
+	};
+	uint64_t prep_cycles = k_cycle_get_64();
+	int ret;
+
+	ret = raw_tx_send_packet(&info);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* The frame timestamp is patched in last, right before sendto(), so the
+	 * build and copies before it are timed from prep_cycles.
+	 */
+	sent->tx_cycles = info.tx_cycles;
+	sent->prep_cycles = prep_cycles;
+	sent->send_cycles = info.tx_cycles;
+	sent->sent_cycles = k_cycle_get_64();
+	return 0;
+}
+
+static void raw_transport_cleanup(struct latency_transport *transport)
+{
+	raw_tx_cleanup();
+}
+
+static const struct latency_transport_api raw_transport_api = {
+	.init = raw_transport_init,
+	.send = raw_transport_send,
+	.cleanup = raw_transport_cleanup,
+};
+#endif /* CONFIG_WIFI_LATENCY_TEST_TRANSPORT_RAW && CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX */
 
 #if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_RX)
 static raw_packet_stats_t rx_stats = {0};
+static struct latency_stats raw_latency_stats;
 #define RAW_PKT_HDR_SIZE    6
 #define TEST_SSID_SIGNATURE "WIFI_LATENCY_TEST"
 
+/* Fixed 802.11 management header layout */
+#define IEEE80211_HDR_LEN      24
+#define IEEE80211_SA_OFFSET    10
+#define IEEE80211_BSSID_OFFSET 16
+
+#if IS_ENABLED(CONFIG_RAW_RX_DEV_PREFILTER_ADDR)
+static uint8_t raw_rx_tx_addr[WIFI_MAC_ADDR_LEN];
+#endif
+
+#if IS_ENABLED(CONFIG_RAW_RX_DEV_MODE_MONITOR)
+#define RAW_RX_CAPTURE_STACK_SIZE CONFIG_RAW_RX_DEV_RX_STACK_SIZE
+#else
+#define RAW_RX_CAPTURE_STACK_SIZE CONFIG_RAW_RX_DEV_MODE_PROMISCUOUS_RX_THREAD_STACK_SIZE
+#endif
+#define RAW_RX_CONSUMER_STACK_SIZE 2048
+
+/* Handed from the capture thread to the consumer thread for each test packet */
+struct raw_rx_event {
+	uint64_t tx_cycles;
+	uint64_t rx_cycles;
+	uint32_t seq;
+	uint16_t len;
+	uint8_t burst_idx;
+	uint8_t burst_len;
+	uint16_t tag;
+	bool meta_valid; /* Only monitor mode frames carry the driver RX header */
+	struct raw_rx_meta meta;
+};
+
+K_MSGQ_DEFINE(raw_rx_msgq, sizeof(struct raw_rx_event), CONFIG_RAW_RX_DEV_RX_QUEUE_DEPTH, 4);
+static atomic_t raw_rx_queue_drops;
+
 /* Function to check if a beacon frame is from the raw_tx_packet project */
 static bool is_raw_tx_packet_beacon(unsigned char *packet, int packet_len)
 {
@@ -266,11 +484,155 @@ static bool is_raw_tx_packet_beacon(unsigned char *packet, int packet_len)
 	return false;
 }
 
+static int raw_decode_test_ie(const struct raw_test_ie *ie, struct raw_test_pkt_info *info)
+{
+	if (ie->element_id != RAW_TEST_IE_ID || ie->length != RAW_TEST_IE_LEN ||
+	    ie->oui[0] != RAW_TEST_IE_OUI_0 || ie->oui[1] != RAW_TEST_IE_OUI_1 ||
+	    ie->oui[2] != RAW_TEST_IE_OUI_2 || ie->oui_type != RAW_TEST_IE_OUI_TYPE) {
+		return -ENOENT;
+	}
+
+	info->seq = sys_get_le32((const uint8_t *)&ie->seq);
+	info->tx_cycles = sys_get_le64((const uint8_t *)&ie->tx_cycles);
+	info->burst_idx = ie->burst_idx;
+	info->burst_len = ie->burst_len;
+	info->tag = sys_get_le16((const uint8_t *)&ie->tag);
+	return 0;
+}
+
+/* Extract sequence number and TX timestamp from the test vendor specific IE */
+static int raw_get_test_info(unsigned char *packet, int packet_len,
+			     struct raw_test_pkt_info *info)
+{
+	/* 24-byte 802.11 header followed by the beacon body */
+	const struct raw_test_ie *ie;
+
+	if (packet_len < 24 + RAW_TEST_IE_OFFSET + (int)sizeof(struct raw_test_ie)) {
+		return -EMSGSIZE;
+	}
+
+	ie = (const struct raw_test_ie *)(packet + 24 + RAW_TEST_IE_OFFSET);
+	return raw_decode_test_ie(ie, info);
+}
+
+/* Update frame type counters */
+static void raw_count_frame(raw_packet_stats_t *stats, const frame_control_t *fc)
+{
+	stats->total_count++;
+	if (fc->type == 2) {
+		stats->data_count++;
+	} else if (fc->type == 0 && fc->subtype == 8) {
+		stats->beacon_count++;
+	}
+}
+
+static int raw_prefilter_init(void)
+{
+#if IS_ENABLED(CONFIG_RAW_RX_DEV_PREFILTER_ADDR)
+	if (net_bytes_from_str(raw_rx_tx_addr, sizeof(raw_rx_tx_addr),
+			       CONFIG_RAW_RX_DEV_PREFILTER_TX_ADDR)) {
+		LOG_ERR("Invalid pre-filter TX address: %s", CONFIG_RAW_RX_DEV_PREFILTER_TX_ADDR);
+		return -EINVAL;
+	}
+#endif
+	return 0;
+}
+
+/* Cheap match on the fixed 802.11 header, rejects foreign frames before any IE walk.
+ * hdr must hold at least IEEE80211_HDR_LEN bytes.
+ */
+static bool raw_prefilter_match(const uint8_t *hdr)
+{
+	const frame_control_t *fc = (const frame_control_t *)hdr;
+
+	if (fc->type != CONFIG_RAW_RX_DEV_PREFILTER_TYPE ||
+	    fc->subtype != CONFIG_RAW_RX_DEV_PREFILTER_SUBTYPE) {
+		return false;
+	}
+
+#if IS_ENABLED(CONFIG_RAW_RX_DEV_PREFILTER_ADDR)
+	if (memcmp(hdr + IEEE80211_SA_OFFSET, raw_rx_tx_addr, sizeof(raw_rx_tx_addr)) != 0 ||
+	    memcmp(hdr + IEEE80211_BSSID_OFFSET, raw_rx_tx_addr, sizeof(raw_rx_tx_addr)) != 0) {
+		return false;
+	}
+#endif
+	return true;
+}
+
+static void raw_count_test_beacon(raw_packet_stats_t *stats)
+{
+	int64_t now = k_uptime_get();
+
+	if (stats->test_beacon_count == 0) {
+		stats->first_packet_timestamp = now;
+	}
+	stats->test_beacon_count++;
+	stats->last_packet_timestamp = now;
+}
+
+bool raw_is_test_packet(unsigned char *packet, int packet_len)
+{
+	return is_raw_tx_packet_beacon(packet, packet_len);
+}
+
+int raw_parse_packet(unsigned char *packet, int packet_len, raw_packet_stats_t *stats,
+		     struct raw_test_pkt_info *info)
+{
+	const frame_control_t *fc = (const frame_control_t *)packet;
+	struct raw_test_pkt_info pkt_info;
+
+	if (packet_len < (int)sizeof(frame_control_t)) {
+		return -EMSGSIZE;
+	}
+
+	raw_count_frame(stats, fc);
+	if (packet_len < IEEE80211_HDR_LEN || !raw_prefilter_match(packet)) {
+		return -ENOENT;
+	}
+
+	if (!is_raw_tx_packet_beacon(packet, packet_len)) {
+		return -ENOENT;
+	}
+
+	if (raw_get_test_info(packet, packet_len, &pkt_info)) {
+		LOG_DBG("Test beacon without latency info IE");
+		return -ENOENT;
+	}
+
+	raw_count_test_beacon(stats);
+
+	if (info) {
+		*info = pkt_info;
+	}
+	return 0;
+}
+
 #ifdef CONFIG_RAW_RX_DEV_MODE_MONITOR
-#define RAW_PKT_HDR 6
+#define RAW_PKT_HDR sizeof(struct raw_rx_pkt_header)
+BUILD_ASSERT(sizeof(struct raw_rx_pkt_header) == RAW_PKT_HDR_SIZE);
+
+/* Monitored channel, follows the TX channel hop schedule */
+static uint8_t raw_rx_channel;
+
+static void raw_rx_meta_decode(const uint8_t *hdr, struct raw_rx_meta *meta)
+{
+	meta->freq_mhz = sys_get_le16(hdr + offsetof(struct raw_rx_pkt_header, frequency));
+	meta->rssi_dbm = (int16_t)sys_get_le16(hdr + offsetof(struct raw_rx_pkt_header, signal));
+	meta->rate_flags = hdr[offsetof(struct raw_rx_pkt_header, rate_flags)];
+	meta->rate = hdr[offsetof(struct raw_rx_pkt_header, rate)];
+}
+
 int raw_rx_dev_monitor_init(void)
 {
+	struct test_params params;
+	uint8_t channel;
 	int ret;
+
+	ret = raw_prefilter_init();
+	if (ret) {
+		return ret;
+	}
+
 	ret = wifi_set_mode(WIFI_MONITOR_MODE);
 	if (ret) {
 		LOG_ERR("Failed to set monitoring mode: %d", ret);
@@ -284,8 +646,10 @@ int raw_rx_dev_monitor_init(void)
 		return ret;
 	}
 
-	/* Set Wi-Fi channel for monitoring */
-	ret = wifi_set_channel(CONFIG_RAW_RX_DEV_MODE_MONITOR_CHANNEL);
+	/* Set Wi-Fi channel for monitoring, a stored channel overrides Kconfig */
+	params_get(&params);
+	channel = params.channel ? params.channel : CONFIG_RAW_RX_DEV_MODE_MONITOR_CHANNEL;
+	ret = wifi_set_channel(channel);
 	if (ret) {
 		LOG_ERR("Failed to set monitoring channel: %d", ret);
 		return ret;
@@ -293,22 +657,128 @@ int raw_rx_dev_monitor_init(void)
 
 	/* Initialize statistics */
 	memset(&rx_stats, 0, sizeof(rx_stats));
+	latency_stats_init(&raw_latency_stats, "raw-monitor");
+	latency_stats_register(&raw_latency_stats);
 
-	LOG_INF("Raw RX monitor mode initialized on channel %d",
-		CONFIG_RAW_RX_DEV_MODE_MONITOR_CHANNEL);
+	raw_rx_channel = channel;
+	LOG_INF("Raw RX monitor mode initialized on channel %d", channel);
 	return 0;
 }
 
-void raw_rx_dev_monitor_task(void)
+#if IS_ENABLED(CONFIG_RAW_RX_DEV_CAPTURE_PKT_FILTER)
+/* Offsets in the received net_pkt: nRF70 raw RX header, then the 802.11 frame */
+#define RAW_NPF_SSID_IE_OFFSET (RAW_PKT_HDR + 24 + 12)
+#define RAW_NPF_TEST_IE_OFFSET (RAW_PKT_HDR + 24 + RAW_TEST_IE_OFFSET)
+
+/* Read len bytes at offset from the fragment chain without linearizing the frame */
+static int raw_npf_read(struct net_pkt *pkt, size_t offset, void *data, size_t len)
+{
+	net_pkt_cursor_init(pkt);
+	if (net_pkt_skip(pkt, offset)) {
+		return -EMSGSIZE;
+	}
+	return net_pkt_read(pkt, data, len);
+}
+
+static int raw_npf_parse(struct net_pkt *pkt, size_t len, struct raw_test_pkt_info *info)
+{
+	const char target_ssid[] = TEST_SSID_SIGNATURE;
+	uint8_t ssid_ie[2 + sizeof(target_ssid) - 1];
+	uint8_t hdr[IEEE80211_HDR_LEN];
+	struct raw_test_ie ie;
+
+	if (raw_npf_read(pkt, RAW_PKT_HDR, hdr, sizeof(frame_control_t))) {
+		return -EMSGSIZE;
+	}
+
+	raw_count_frame(&rx_stats, (const frame_control_t *)hdr);
+	if (raw_npf_read(pkt, RAW_PKT_HDR, hdr, sizeof(hdr)) || !raw_prefilter_match(hdr)) {
+		return -ENOENT;
+	}
+
+	if (len < RAW_NPF_TEST_IE_OFFSET + sizeof(ie) ||
+	    raw_npf_read(pkt, RAW_NPF_SSID_IE_OFFSET, ssid_ie, sizeof(ssid_ie)) ||
+	    ssid_ie[0] != 0 || ssid_ie[1] != sizeof(target_ssid) - 1 ||
+	    memcmp(&ssid_ie[2], target_ssid, sizeof(target_ssid) - 1) != 0) {
+		return -ENOENT;
+	}
+
+	if (raw_npf_read(pkt, RAW_NPF_TEST_IE_OFFSET, &ie, sizeof(ie)) ||
+	    raw_decode_test_ie(&ie, info)) {
+		return -ENOENT;
+	}
+
+	raw_count_test_beacon(&rx_stats);
+	return 0;
+}
+
+/* Runs in the driver RX path for every frame received in monitor mode. Test
+ * beacons are posted to the consumer; the rule verdict drops every frame before
+ * it is queued to the stack, so a frame holds its RX buffers only for this call.
+ */
+static bool raw_npf_capture(struct npf_test *test, struct net_pkt *pkt)
+{
+	uint64_t rx_cycles = k_cycle_get_64();
+	size_t len = net_pkt_get_len(pkt);
+	uint8_t hdr[RAW_PKT_HDR];
+	struct net_pkt_cursor backup;
+	struct raw_test_pkt_info info;
+	struct raw_rx_event evt;
+	int ret;
+
+	ARG_UNUSED(test);
+
+#if IS_ENABLED(CONFIG_NET_PKT_TIMESTAMP)
+	/* Prefer the driver RX time when it stamps packets on the uptime clock */
+	if (net_pkt_timestamp_ns(pkt) > 0) {
+		rx_cycles = k_ns_to_cyc_floor64(net_pkt_timestamp_ns(pkt));
+	}
+#endif
+
+	net_pkt_cursor_backup(pkt, &backup);
+	ret = raw_npf_parse(pkt, len, &info);
+	if (ret == 0) {
+		ret = raw_npf_read(pkt, 0, hdr, sizeof(hdr));
+	}
+	net_pkt_cursor_restore(pkt, &backup);
+	if (ret) {
+		return true;
+	}
+
+	led_trigger_rx();
+	evt.meta_valid = true;
+	raw_rx_meta_decode(hdr, &evt.meta);
+	evt.tx_cycles = info.tx_cycles;
+	evt.rx_cycles = rx_cycles;
+	evt.seq = info.seq;
+	evt.len = len;
+	evt.burst_idx = info.burst_idx;
+	evt.burst_len = info.burst_len;
+	evt.tag = info.tag;
+	if (k_msgq_put(&raw_rx_msgq, &evt, K_NO_WAIT)) {
+		atomic_inc(&raw_rx_queue_drops);
+	}
+	return true;
+}
+
+static struct npf_test raw_npf_capture_test = {
+	.fn = raw_npf_capture,
+};
+
+NPF_RULE(raw_npf_capture_rule, NET_DROP, raw_npf_capture_test);
+#else
+static void raw_rx_capture(void)
 {
 	int ret;
 	int sockfd;
-	char recv_buffer[1024];
+	char recv_buffer[MAX(1024, RAW_PKT_HDR + sizeof(struct beacon_frame))];
 	int recv_len;
 	struct sockaddr_ll sa;
-	int packet_count = 0;
+	struct raw_test_pkt_info info;
+	struct raw_rx_event evt;
+	uint64_t rx_cycles;
 
-	LOG_INF("Raw RX monitor task started");
+	LOG_INF("Raw RX monitor capture started");
 
 	/* Create raw socket for packet capture */
 	sockfd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
@@ -345,43 +815,64 @@ void raw_rx_dev_monitor_task(void)
 
 			if (recv_len < 0) {
 				LOG_ERR("Monitor : recv error %s", strerror(errno));
-				ret = -errno;
 			}
 			break;
 		}
 
-		LOG_DBG("Received %d bytes", recv_len);
-		if (is_raw_tx_packet_beacon((unsigned char *)(recv_buffer + RAW_PKT_HDR),
-					    recv_len - RAW_PKT_HDR)) {
+		rx_cycles = k_cycle_get_64();
+		if (raw_parse_packet((unsigned char *)(recv_buffer + RAW_PKT_HDR),
+				     recv_len - RAW_PKT_HDR, &rx_stats, &info) == 0) {
 			led_trigger_rx();
-			packet_count++;
-			/* Parse received packet */
-			LOG_INF("Received test packet #%u", packet_count);
+			evt.meta_valid = true;
+			raw_rx_meta_decode((const uint8_t *)recv_buffer, &evt.meta);
+			evt.tx_cycles = info.tx_cycles;
+			evt.rx_cycles = rx_cycles;
+			evt.seq = info.seq;
+			evt.len = recv_len;
+			evt.burst_idx = info.burst_idx;
+			evt.burst_len = info.burst_len;
+			evt.tag = info.tag;
+			if (k_msgq_put(&raw_rx_msgq, &evt, K_NO_WAIT)) {
+				atomic_inc(&raw_rx_queue_drops);
+			}
 		}
 	}
 	close(sockfd);
 }
+#endif /* CONFIG_RAW_RX_DEV_CAPTURE_PKT_FILTER */
 #endif /* CONFIG_RAW_RX_DEV_MODE_MONITOR */
 
 #ifdef CONFIG_RAW_RX_DEV_MODE_PROMISCUOUS
 
 int raw_rx_dev_promiscuous_init(void)
 {
+	int ret;
+
+	ret = raw_prefilter_init();
+	if (ret) {
+		return ret;
+	}
+
 	/* Initialize statistics */
 	memset(&rx_stats, 0, sizeof(rx_stats));
+	latency_stats_init(&raw_latency_stats, "raw-promisc");
+	latency_stats_register(&raw_latency_stats);
 
 	LOG_INF("Raw RX promiscuous mode initialized");
 	return 0;
 }
 
-void raw_rx_dev_promiscuous_task(void)
+static void raw_rx_capture(void)
 {
 	int sockfd;
 	char recv_buffer[CONFIG_RAW_RX_DEV_MODE_PROMISCUOUS_RECV_BUFFER_SIZE];
 	int recv_len;
 	struct sockaddr_ll sa;
+	struct raw_test_pkt_info info;
+	struct raw_rx_event evt;
+	uint64_t rx_cycles;
 
-	LOG_INF("Raw RX promiscuous task started");
+	LOG_INF("Raw RX promiscuous capture started");
 
 	/* Create raw socket for packet capture */
 	sockfd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
@@ -410,24 +901,207 @@ void raw_rx_dev_promiscuous_task(void)
 	LOG_INF("Promiscuous mode listening for raw packets...");
 
 	while (1) {
+		/* Blocking receive; the thread sleeps until a frame arrives */
 		recv_len = recvfrom(sockfd, recv_buffer, sizeof(recv_buffer), 0, NULL, NULL);
 		if (recv_len < 0) {
-			LOG_ERR("Failed to receive packet: %s", strerror(errno));
-			continue;
-		}
+			if (errno == EAGAIN || errno == EINTR) {
+				continue;
+			}
 
-		/* Parse received packet */
-		if (raw_parse_packet((unsigned char *)recv_buffer, recv_len, &rx_stats) == 0) {
-			/* Successfully processed our test packet */
-			LOG_DBG("Processed test packet (total: %d)", rx_stats.test_beacon_count);
+			/* Retrying a dead socket would spin this cooperative thread */
+			LOG_ERR("Promiscuous : recv error %s", strerror(errno));
+			break;
 		}
 
-		/* Brief yield to prevent hogging CPU */
-		k_yield();
+		rx_cycles = k_cycle_get_64();
+		if (raw_parse_packet((unsigned char *)recv_buffer, recv_len, &rx_stats,
+				     &info) == 0) {
+			evt.meta_valid = false;
+			evt.tx_cycles = info.tx_cycles;
+			evt.rx_cycles = rx_cycles;
+			evt.seq = info.seq;
+			evt.len = recv_len;
+			evt.burst_idx = info.burst_idx;
+			evt.burst_len = info.burst_len;
+			evt.tag = info.tag;
+			if (k_msgq_put(&raw_rx_msgq, &evt, K_NO_WAIT)) {
+				atomic_inc(&raw_rx_queue_drops);
+			}
+		}
 	}
 
 	close(sockfd);
 }
 #endif /* CONFIG_RAW_RX_DEV_MODE_PROMISCUOUS */
+
+#if !IS_ENABLED(CONFIG_RAW_RX_DEV_CAPTURE_PKT_FILTER)
+static void raw_rx_capture_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	raw_rx_capture();
+	LOG_WRN("Raw RX capture stopped");
+}
+
+K_THREAD_DEFINE(raw_rx_capture_tid, RAW_RX_CAPTURE_STACK_SIZE, raw_rx_capture_thread, NULL, NULL,
+		NULL, CONFIG_RAW_RX_DEV_RX_THREAD_PRIORITY, 0, K_TICKS_FOREVER);
+#endif
+
+#if IS_ENABLED(CONFIG_RAW_RX_DEV_MODE_MONITOR)
+/* Follow a channel hop announced by the TX device */
+static void raw_rx_hop_switch(uint16_t tag)
+{
+	uint8_t channel = hop_tag_channel(tag);
+	uint64_t start;
+	int ret;
+
+	/* The announcement is repeated, act on its first frame */
+	if (raw_latency_stats.tag == tag) {
+		return;
+	}
+
+	if (hop_tag_is_point(raw_latency_stats.tag)) {
+		struct latency_stats_summary summary;
+
+		latency_stats_get_summary(&raw_latency_stats, &summary);
+		hop_record(&summary);
+	}
+	latency_stats_set_tag(&raw_latency_stats, tag);
+
+	if (channel != raw_rx_channel) {
+		start = k_cycle_get_64();
+		ret = wifi_set_channel(channel);
+		if (ret) {
+			LOG_ERR("Failed to follow hop to channel %u: %d", channel, ret);
+		} else {
+			hop_switch_record(channel, k_cyc_to_us_floor64(k_cycle_get_64() - start));
+			raw_rx_channel = channel;
+		}
+	}
+
+	if (tag & HOP_TAG_END) {
+		hop_report();
+	}
+}
+#endif /* CONFIG_RAW_RX_DEV_MODE_MONITOR */
+
+/* Runs below the capture thread: stats, tracing and logging never delay a recv() */
+static void raw_rx_consumer_thread(void *p1, void *p2, void *p3)
+{
+	struct raw_rx_event evt;
+	atomic_val_t drops, reported_drops = 0;
+	uint32_t packet_count = 0;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		k_msgq_get(&raw_rx_msgq, &evt, K_FOREVER);
+		packet_count++;
+
+#if IS_ENABLED(CONFIG_RAW_RX_DEV_MODE_MONITOR)
+		if (hop_tag_is_point(evt.tag) || hop_tag_is_switch(evt.tag)) {
+			hop_frame_record(evt.tag, k_cyc_to_us_floor64(evt.rx_cycles));
+		}
+		if (hop_tag_is_switch(evt.tag)) {
+			/* Announcements are not part of any dwell */
+			raw_rx_hop_switch(evt.tag);
+			continue;
+		}
+#endif
+
+		if (evt.tag != raw_latency_stats.tag && sweep_tag_is_point(raw_latency_stats.tag)) {
+			struct latency_stats_summary summary;
+
+			/* Sweep point finished, rank it before the counters are reset */
+			latency_stats_get_summary(&raw_latency_stats, &summary);
+			sweep_record(&summary);
+			if (evt.tag == SWEEP_TAG_END) {
+				sweep_report();
+			}
+		}
+		boot_mark(BOOT_PHASE_FIRST_PACKET);
+		latency_stats_set_tag(&raw_latency_stats, evt.tag);
+		latency_stats_update(&raw_latency_stats, evt.seq,
+				     k_cyc_to_us_floor64(evt.tx_cycles),
+				     k_cyc_to_us_floor64(evt.rx_cycles), evt.len);
+		if (evt.burst_len > 1) {
+			latency_stats_update_burst(&raw_latency_stats, evt.seq, evt.burst_idx,
+						   evt.burst_len, evt.len,
+						   k_cyc_to_us_floor64(evt.tx_cycles),
+						   k_cyc_to_us_floor64(evt.rx_cycles));
+		}
+		if (evt.meta_valid) {
+			latency_stats_update_link(&raw_latency_stats, evt.meta.rssi_dbm,
+						  evt.meta.rate, evt.meta.rate_flags);
+		}
+		if (IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRACE)) {
+			int8_t rssi = evt.meta_valid ? CLAMP(evt.meta.rssi_dbm, INT8_MIN, 0) : 0;
+
+			trace_utils_record(TRACE_EVT_RX, TRACE_STREAM_RAW, evt.seq, evt.rx_cycles,
+					   rssi, evt.len);
+		} else if (!IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_THROUGHPUT) && evt.meta_valid) {
+			LOG_INF("Received test packet #%u: seq %u, TX cycles %llu, %u MHz %d dBm "
+				"rate %u/0x%x",
+				packet_count, evt.seq, evt.tx_cycles, evt.meta.freq_mhz,
+				evt.meta.rssi_dbm, evt.meta.rate, evt.meta.rate_flags);
+		} else if (!IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_THROUGHPUT)) {
+			LOG_INF("Received test packet #%u: seq %u, TX cycles %llu", packet_count,
+				evt.seq, evt.tx_cycles);
+		}
+
+		drops = atomic_get(&raw_rx_queue_drops);
+		if (drops != reported_drops) {
+			LOG_WRN("RX queue full, %ld events dropped", (long)drops);
+			reported_drops = drops;
+		}
+	}
+}
+
+K_THREAD_DEFINE(raw_rx_consumer_tid, RAW_RX_CONSUMER_STACK_SIZE, raw_rx_consumer_thread, NULL,
+		NULL, NULL, CONFIG_RAW_RX_DEV_CONSUMER_THREAD_PRIORITY, 0, K_TICKS_FOREVER);
+
+int raw_rx_dev_start(void)
+{
+	k_thread_name_set(raw_rx_consumer_tid, "raw_rx_consumer");
+	k_thread_start(raw_rx_consumer_tid);
+
+#if IS_ENABLED(CONFIG_RAW_RX_DEV_CAPTURE_PKT_FILTER)
+	npf_append_recv_rule(&raw_npf_capture_rule);
+	LOG_INF("Raw RX capture installed as packet filter");
+#else
+	k_thread_name_set(raw_rx_capture_tid, "raw_rx_capture");
+	k_thread_start(raw_rx_capture_tid);
+
+	LOG_INF("Raw RX capture thread started at priority %d",
+		CONFIG_RAW_RX_DEV_RX_THREAD_PRIORITY);
+#endif
+	return 0;
+}
+
+static int raw_transport_recv(struct latency_transport *transport)
+{
+	return raw_rx_dev_start();
+}
+
+static const struct latency_transport_api raw_transport_api = {
+	.recv = raw_transport_recv,
+};
 #endif /* CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_RX */
-#endif /* IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_PACKET_TYPE_RAW) */
+
+/* A failed injection ends the session instead of counting as a lost frame */
+static struct latency_transport raw_transport = {
+	.api = &raw_transport_api,
+	.name = "Raw",
+	.stop_on_error = true,
+	.trace_stream = TRACE_STREAM_RAW,
+};
+
+struct latency_transport *raw_transport_get(void)
+{
+	return &raw_transport;
+}
+#endif /* IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRANSPORT_RAW) */
@@ -12,10 +12,8 @@
 #include <zephyr/net/net_if.h>
 #include <zephyr/net/wifi_mgmt.h>
 
-/* External declarations for shared TX control variables */
-extern struct k_sem tx_start_sem;
-extern volatile bool tx_task_running;
-extern volatile bool tx_task_should_stop;
+#include "engine_utils.h"
+#include "params_utils.h"
 
 /* Raw packet header structure */
 struct raw_tx_pkt_header {
@@ -27,6 +25,25 @@ struct raw_tx_pkt_header {
 	unsigned char raw_tx_flag;
 };
 
+/* Header the nRF70 driver puts in front of every frame received in monitor mode */
+struct raw_rx_pkt_header {
+	uint16_t frequency; /* Channel center frequency in MHz */
+	uint16_t signal;    /* Signal strength in dBm, two's complement */
+	uint8_t rate_flags;
+	uint8_t rate;
+} __packed;
+
+/* Radio metadata of a received frame, decoded from struct raw_rx_pkt_header */
+struct raw_rx_meta {
+	uint16_t freq_mhz;
+	int16_t rssi_dbm;
+	uint8_t rate_flags;
+	uint8_t rate; /* Legacy rate or MCS index, as reported by the driver */
+};
+
+/* Template beacon body plus the configured padding */
+#define RAW_BEACON_BODY_LEN (256 + CONFIG_WIFI_LATENCY_TEST_PAYLOAD_SIZE)
+
 /* Beacon frame structure for raw transmission */
 struct beacon_frame {
 	uint16_t frame_control;
@@ -35,9 +52,43 @@ struct beacon_frame {
 	uint8_t sa[6];
 	uint8_t bssid[6];
 	uint16_t seq_ctrl;
-	uint8_t payload[256];
+	uint8_t payload[RAW_BEACON_BODY_LEN];
+} __packed;
+
+/* Vendor specific IE carrying per-packet test information. It sits at a fixed
+ * offset in the beacon body, right after the template IEs, so the receiver can
+ * read it without walking the IE list.
+ */
+#define RAW_TEST_IE_ID       0xDD
+#define RAW_TEST_IE_OUI_0    0xF4 /* Nordic Semiconductor OUI F4:CE:36 */
+#define RAW_TEST_IE_OUI_1    0xCE
+#define RAW_TEST_IE_OUI_2    0x36
+#define RAW_TEST_IE_OUI_TYPE 0x4C
+#define RAW_TEST_IE_OFFSET   205
+#define RAW_TEST_IE_LEN      (sizeof(struct raw_test_ie) - 2)
+
+/* Fields are little-endian on air */
+struct raw_test_ie {
+	uint8_t element_id;
+	uint8_t length;
+	uint8_t oui[3];
+	uint8_t oui_type;
+	uint32_t seq;
+	uint64_t tx_cycles;
+	uint8_t burst_idx;
+	uint8_t burst_len;
+	uint16_t tag;
 } __packed;
 
+/* Per-packet information extracted from a received test frame */
+struct raw_test_pkt_info {
+	uint32_t seq;
+	uint64_t tx_cycles; /* k_cycle_get_64() on the TX device */
+	uint8_t burst_idx;
+	uint8_t burst_len;
+	uint16_t tag; /* Test phase, e.g. throughput step; 0 when untagged */
+};
+
 /* Frame control structure for parsing received frames */
 typedef struct {
 	uint16_t protocolVersion: 2;
@@ -77,19 +128,40 @@ int raw_tx_init(void);
  */
 int raw_tx_socket_init(void);
 
+/**
+ * @brief Apply the runtime rate, queue, payload size and channel for the next session
+ *
+ * @param params Runtime test parameters
+ * @return 0 on success, negative error code on failure
+ */
+int raw_tx_configure(const struct test_params *params);
+
 /**
  * @brief Send a raw packet with timing measurement
  *
- * @param packet_num Packet sequence number for identification
+ * @param info Sequence number, burst position and tag to embed. The TX
+ *             timestamp is sampled by this function right before sendto()
+ *             and returned in tx_cycles.
  * @return 0 on success, negative error code on failure
  */
-int raw_tx_send_packet(uint32_t packet_num);
+int raw_tx_send_packet(struct raw_test_pkt_info *info);
 
 /**
  * @brief Cleanup raw packet transmission
  */
 void raw_tx_cleanup(void);
 
+/**
+ * @brief Get the raw transport of the latency engine
+ *
+ * On a TX device init() applies the session parameters and opens the raw
+ * socket, send() injects one test beacon. On an RX device recv() starts the
+ * capture of the configured raw RX mode, which must be initialized first.
+ *
+ * @return Raw transport
+ */
+struct latency_transport *raw_transport_get(void);
+
 /**
  * @brief Initialize raw packet reception (monitor mode)
  *
@@ -105,18 +177,15 @@ int raw_rx_dev_monitor_init(void);
 int raw_rx_dev_promiscuous_init(void);
 
 /**
- * @brief Main raw packet RX task function (monitor mode)
+ * @brief Start the raw packet RX capture and consumer threads
  *
- * This function runs the main reception loop for raw packets in monitor mode
- */
-void raw_rx_dev_monitor_task(void);
-
-/**
- * @brief Main raw packet RX task function (promiscuous mode)
+ * The capture thread runs the reception loop of the configured mode at
+ * CONFIG_RAW_RX_DEV_RX_THREAD_PRIORITY and hands test packets to a lower
+ * priority consumer thread for statistics and logging.
  *
- * This function runs the main reception loop for raw packets in promiscuous mode
+ * @return 0 on success, negative error code on failure
  */
-void raw_rx_dev_promiscuous_task(void);
+int raw_rx_dev_start(void);
 
 /**
  * @brief Parse received raw packet and extract timing information
@@ -124,9 +193,11 @@ void raw_rx_dev_promiscuous_task(void);
  * @param packet Pointer to the received packet data
  * @param packet_len Length of the received packet
  * @param stats Pointer to statistics structure to update
+ * @param info Filled with sequence number and TX timestamp of a test packet, may be NULL
  * @return 0 if packet is recognized, negative if not our test packet
  */
-int raw_parse_packet(unsigned char *packet, int packet_len, raw_packet_stats_t *stats);
+int raw_parse_packet(unsigned char *packet, int packet_len, raw_packet_stats_t *stats,
+		     struct raw_test_pkt_info *info);
 
 /**
  * @brief Check if a packet is from our test application
@@ -0,0 +1,536 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/net_mgmt.h>
+#include <zephyr/net/net_stats.h>
+#include <zephyr/sys/util.h>
+#include <string.h>
+
+#include "pool_utils.h"
+#include "stats_utils.h"
+
+LOG_MODULE_REGISTER(stats_utils, CONFIG_LOG_DEFAULT_LEVEL);
+
+static sys_slist_t stats_list = SYS_SLIST_STATIC_INIT(&stats_list);
+static K_MUTEX_DEFINE(stats_list_mutex);
+
+static void stats_report_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(stats_report_work, stats_report_work_handler);
+
+static uint32_t hist_index(uint32_t value_us)
+{
+	uint32_t msb;
+	uint32_t shift;
+
+	if (value_us < LATENCY_HIST_SUB_COUNT) {
+		return value_us;
+	}
+
+	msb = 31 - __builtin_clz(value_us);
+	if (msb > LATENCY_HIST_MAX_BITS) {
+		return LATENCY_HIST_BUCKETS - 1;
+	}
+
+	shift = msb - LATENCY_HIST_SUB_BITS;
+	return (shift + 1) * LATENCY_HIST_SUB_COUNT +
+	       ((value_us >> shift) & (LATENCY_HIST_SUB_COUNT - 1));
+}
+
+/* Midpoint of the value range covered by a bucket */
+static uint32_t hist_value(uint32_t index)
+{
+	uint32_t group = index / LATENCY_HIST_SUB_COUNT;
+	uint32_t sub = index % LATENCY_HIST_SUB_COUNT;
+	uint32_t shift;
+
+	if (group == 0) {
+		return sub;
+	}
+
+	shift = group - 1;
+	return ((LATENCY_HIST_SUB_COUNT + sub) << shift) + (BIT(shift) >> 1);
+}
+
+static void hist_record(struct latency_hist *hist, uint32_t value_us)
+{
+	hist->buckets[hist_index(value_us)]++;
+	if (hist->count == 0 || value_us < hist->min_us) {
+		hist->min_us = value_us;
+	}
+	if (value_us > hist->max_us) {
+		hist->max_us = value_us;
+	}
+	hist->count++;
+	hist->sum_us += value_us;
+}
+
+static uint32_t hist_percentile(const struct latency_hist *hist, uint32_t per_10k)
+{
+	uint64_t target;
+	uint64_t cumulative = 0;
+
+	if (hist->count == 0) {
+		return 0;
+	}
+
+	target = DIV_ROUND_UP((uint64_t)hist->count * MIN(per_10k, 10000), 10000);
+	target = MAX(target, 1);
+
+	for (uint32_t i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+		cumulative += hist->buckets[i];
+		if (cumulative >= target) {
+			/* Bucket midpoints can fall outside the observed range */
+			return CLAMP(hist_value(i), hist->min_us, hist->max_us);
+		}
+	}
+
+	return hist->max_us;
+}
+
+static void seq_record(struct latency_stats *stats, uint32_t seq)
+{
+	int32_t diff;
+
+	if (!stats->seq_valid) {
+		stats->seq_valid = true;
+		stats->highest_seq = seq;
+		stats->seq_window = 1;
+		stats->received++;
+		return;
+	}
+
+	diff = (int32_t)(seq - stats->highest_seq);
+	if (diff > 0) {
+		/* New highest sequence number, anything skipped is lost for now */
+		stats->lost += diff - 1;
+		stats->seq_window = (diff >= LATENCY_SEQ_WINDOW) ? 0 : stats->seq_window << diff;
+		stats->seq_window |= 1;
+		stats->highest_seq = seq;
+		stats->received++;
+	} else if (diff == 0) {
+		stats->duplicates++;
+	} else {
+		/* Within the window, latency_stats_update() handles larger jumps back */
+		uint64_t bit = BIT64(-diff);
+
+		if (stats->seq_window & bit) {
+			stats->duplicates++;
+		} else {
+			/* Late packet filling an earlier gap */
+			stats->seq_window |= bit;
+			stats->reordered++;
+			stats->received++;
+			if (stats->lost) {
+				stats->lost--;
+			}
+		}
+	}
+}
+
+void latency_stats_init(struct latency_stats *stats, const char *name)
+{
+	memset(stats, 0, sizeof(*stats));
+	stats->name = name;
+}
+
+void latency_stats_reset(struct latency_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats->lock);
+
+	stats->seq_valid = false;
+	stats->highest_seq = 0;
+	stats->seq_window = 0;
+	stats->received = 0;
+	stats->lost = 0;
+	stats->duplicates = 0;
+	stats->reordered = 0;
+	stats->transit_valid = false;
+	stats->last_transit_us = 0;
+	stats->jitter_q4 = 0;
+	stats->baseline_transit_us = 0;
+	stats->bytes = 0;
+	stats->first_rx_us = 0;
+	stats->last_rx_us = 0;
+	memset(&stats->hist, 0, sizeof(stats->hist));
+	memset(&stats->burst, 0, sizeof(stats->burst));
+	memset(&stats->link, 0, sizeof(stats->link));
+
+	k_spin_unlock(&stats->lock, key);
+}
+
+void latency_stats_set_clock_offset(struct latency_stats *stats, int64_t offset_us)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats->lock);
+
+	stats->clock_offset_us = offset_us;
+	stats->clock_offset_valid = true;
+
+	k_spin_unlock(&stats->lock, key);
+}
+
+void latency_stats_update(struct latency_stats *stats, uint32_t seq, int64_t tx_us,
+			  int64_t rx_us, uint16_t len)
+{
+	int64_t transit = rx_us - tx_us;
+	int64_t latency;
+	k_spinlock_key_t key;
+
+	/* A restarted sender begins again at sequence 0 under the same tag. Only
+	 * this thread writes the sequence state, so it is read without the lock.
+	 */
+	if (stats->seq_valid && (int32_t)(stats->highest_seq - seq) >= LATENCY_SEQ_WINDOW) {
+		LOG_INF("[%s] Sender restarted at seq %u after seq %u", stats->name, seq,
+			stats->highest_seq);
+		latency_stats_print(stats);
+		latency_stats_reset(stats);
+	}
+
+	key = k_spin_lock(&stats->lock);
+
+	if (stats->bytes == 0) {
+		stats->first_rx_us = rx_us;
+	}
+	stats->bytes += len;
+	stats->last_rx_us = rx_us;
+
+	seq_record(stats, seq);
+
+	/* Clock offset cancels out of transit differences */
+	if (stats->transit_valid) {
+		int64_t d = transit - stats->last_transit_us;
+		uint64_t abs_d = (d < 0) ? -d : d;
+
+		stats->jitter_q4 += abs_d - ((stats->jitter_q4 + 8) >> 4);
+	} else {
+		stats->baseline_transit_us = transit;
+	}
+	stats->last_transit_us = transit;
+	stats->transit_valid = true;
+
+	if (stats->clock_offset_valid) {
+		latency = transit + stats->clock_offset_us;
+	} else {
+		latency = transit - stats->baseline_transit_us;
+	}
+	hist_record(&stats->hist, (uint32_t)CLAMP(latency, 0, UINT32_MAX));
+
+	k_spin_unlock(&stats->lock, key);
+}
+
+void latency_stats_set_tag(struct latency_stats *stats, uint16_t tag)
+{
+	if (stats->tag == tag) {
+		return;
+	}
+
+	if (stats->received) {
+		latency_stats_print(stats);
+	}
+	latency_stats_reset(stats);
+	stats->tag = tag;
+}
+
+static void burst_close(struct latency_burst *burst)
+{
+	if (burst->frames >= 2) {
+		uint32_t disp = (uint32_t)CLAMP(burst->last_rx_us - burst->first_rx_us, 0,
+						UINT32_MAX);
+
+		burst->count++;
+		burst->disp_sum_us += disp;
+		burst->disp_max_us = MAX(burst->disp_max_us, disp);
+		burst->tx_disp_sum_us +=
+			CLAMP(burst->last_tx_us - burst->first_tx_us, 0, UINT32_MAX);
+		burst->bytes_sum += burst->bytes;
+		LOG_DBG("Burst %u: %u frames, dispersion %u us", burst->start_seq, burst->frames,
+			disp);
+	}
+	burst->open = false;
+}
+
+void latency_stats_update_burst(struct latency_stats *stats, uint32_t seq, uint8_t burst_idx,
+				uint8_t burst_len, uint16_t len, int64_t tx_us, int64_t rx_us)
+{
+	struct latency_burst *burst = &stats->burst;
+	uint32_t start_seq = seq - burst_idx;
+	k_spinlock_key_t key = k_spin_lock(&stats->lock);
+
+	if (burst->open && burst->start_seq != start_seq) {
+		/* Tail of the previous burst was lost */
+		burst_close(burst);
+	}
+
+	if (!burst->open) {
+		burst->open = true;
+		burst->start_seq = start_seq;
+		burst->frames = 0;
+		burst->bytes = 0;
+		burst->first_tx_us = tx_us;
+		burst->first_rx_us = rx_us;
+	} else {
+		burst->bytes += len;
+	}
+	burst->frames++;
+	burst->last_tx_us = tx_us;
+	burst->last_rx_us = rx_us;
+
+	if (burst_idx + 1 >= burst_len) {
+		burst_close(burst);
+	}
+
+	k_spin_unlock(&stats->lock, key);
+}
+
+void latency_stats_update_link(struct latency_stats *stats, int16_t rssi_dbm, uint8_t rate,
+			       uint8_t rate_flags)
+{
+	struct latency_link *link = &stats->link;
+	k_spinlock_key_t key = k_spin_lock(&stats->lock);
+
+	if (link->count == 0 || rssi_dbm < link->rssi_min_dbm) {
+		link->rssi_min_dbm = rssi_dbm;
+	}
+	if (link->count == 0 || rssi_dbm > link->rssi_max_dbm) {
+		link->rssi_max_dbm = rssi_dbm;
+	}
+	if (link->count && (rate != link->rate || rate_flags != link->rate_flags)) {
+		link->rate_changes++;
+	}
+	link->rssi_sum_dbm += rssi_dbm;
+	link->rate = rate;
+	link->rate_flags = rate_flags;
+	link->count++;
+
+	/* The histogram maximum only moves when the packet just recorded set it */
+	if (link->count == 1 || stats->hist.max_us != link->tail_max_us) {
+		link->tail_max_us = stats->hist.max_us;
+		link->tail_rssi_dbm = rssi_dbm;
+		link->tail_rate = rate;
+		link->tail_rate_flags = rate_flags;
+	}
+
+	k_spin_unlock(&stats->lock, key);
+}
+
+uint32_t latency_stats_percentile(struct latency_stats *stats, uint32_t per_10k)
+{
+	uint32_t value;
+	k_spinlock_key_t key = k_spin_lock(&stats->lock);
+
+	value = hist_percentile(&stats->hist, per_10k);
+
+	k_spin_unlock(&stats->lock, key);
+	return value;
+}
+
+void latency_stats_get_summary(struct latency_stats *stats, struct latency_stats_summary *summary)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats->lock);
+	const struct latency_hist *hist = &stats->hist;
+
+	summary->received = stats->received;
+	summary->lost = stats->lost;
+	summary->duplicates = stats->duplicates;
+	summary->reordered = stats->reordered;
+	summary->jitter_us = (uint32_t)(stats->jitter_q4 >> 4);
+	summary->goodput_kbps =
+		(stats->last_rx_us > stats->first_rx_us)
+			? (uint32_t)(stats->bytes * 8000 / (stats->last_rx_us - stats->first_rx_us))
+			: 0;
+	summary->tag = stats->tag;
+	summary->count = hist->count;
+	summary->min_us = hist->min_us;
+	summary->avg_us = hist->count ? (uint32_t)(hist->sum_us / hist->count) : 0;
+	summary->max_us = hist->max_us;
+	summary->p50_us = hist_percentile(hist, 5000);
+	summary->p90_us = hist_percentile(hist, 9000);
+	summary->p99_us = hist_percentile(hist, 9900);
+	summary->p999_us = hist_percentile(hist, 9990);
+	summary->absolute = stats->clock_offset_valid;
+
+	summary->bursts = stats->burst.count;
+	if (stats->burst.count) {
+		summary->burst_disp_avg_us = stats->burst.disp_sum_us / stats->burst.count;
+		summary->burst_disp_max_us = stats->burst.disp_max_us;
+		summary->burst_tx_disp_avg_us = stats->burst.tx_disp_sum_us / stats->burst.count;
+	} else {
+		summary->burst_disp_avg_us = 0;
+		summary->burst_disp_max_us = 0;
+		summary->burst_tx_disp_avg_us = 0;
+	}
+	summary->burst_rate_kbps =
+		stats->burst.disp_sum_us
+			? (uint32_t)(stats->burst.bytes_sum * 8000 / stats->burst.disp_sum_us)
+			: 0;
+
+	summary->link_count = stats->link.count;
+	summary->rssi_min_dbm = stats->link.rssi_min_dbm;
+	summary->rssi_avg_dbm =
+		stats->link.count ? (int16_t)(stats->link.rssi_sum_dbm / (int32_t)stats->link.count)
+				  : 0;
+	summary->rssi_max_dbm = stats->link.rssi_max_dbm;
+	summary->rate = stats->link.rate;
+	summary->rate_flags = stats->link.rate_flags;
+	summary->rate_changes = stats->link.rate_changes;
+	summary->tail_rssi_dbm = stats->link.tail_rssi_dbm;
+	summary->tail_rate = stats->link.tail_rate;
+	summary->tail_rate_flags = stats->link.tail_rate_flags;
+
+	k_spin_unlock(&stats->lock, key);
+}
+
+void latency_stats_print(struct latency_stats *stats)
+{
+	struct latency_stats_summary summary;
+
+	latency_stats_get_summary(stats, &summary);
+
+	LOG_INF("[%s/%u] rx %u lost %u dup %u reorder %u jitter %u us goodput %u kbps",
+		stats->name, summary.tag, summary.received, summary.lost, summary.duplicates,
+		summary.reordered, summary.jitter_us, summary.goodput_kbps);
+	if (summary.count == 0) {
+		return;
+	}
+	LOG_INF("[%s/%u] %s latency us: min %u avg %u max %u p50 %u p90 %u p99 %u p99.9 %u",
+		stats->name, summary.tag, summary.absolute ? "abs" : "rel", summary.min_us,
+		summary.avg_us, summary.max_us, summary.p50_us, summary.p90_us, summary.p99_us,
+		summary.p999_us);
+	if (summary.bursts) {
+		LOG_INF("[%s/%u] bursts %u dispersion us: avg %u max %u tx avg %u rate %u kbps",
+			stats->name, summary.tag, summary.bursts, summary.burst_disp_avg_us,
+			summary.burst_disp_max_us, summary.burst_tx_disp_avg_us,
+			summary.burst_rate_kbps);
+	}
+	if (summary.link_count) {
+		LOG_INF("[%s/%u] rssi dBm: min %d avg %d max %d rate %u/0x%x changes %u, "
+			"max latency at %d dBm rate %u/0x%x",
+			stats->name, summary.tag, summary.rssi_min_dbm, summary.rssi_avg_dbm,
+			summary.rssi_max_dbm, summary.rate, summary.rate_flags,
+			summary.rate_changes, summary.tail_rssi_dbm, summary.tail_rate,
+			summary.tail_rate_flags);
+	}
+}
+
+static void stats_report_work_handler(struct k_work *work)
+{
+	struct latency_stats *stats;
+
+	k_mutex_lock(&stats_list_mutex, K_FOREVER);
+	SYS_SLIST_FOR_EACH_CONTAINER(&stats_list, stats, node) {
+		latency_stats_print(stats);
+	}
+	k_mutex_unlock(&stats_list_mutex);
+	pool_monitor_print();
+
+	k_work_schedule(&stats_report_work,
+			K_SECONDS(CONFIG_WIFI_LATENCY_TEST_STATS_REPORT_INTERVAL_S));
+}
+
+void latency_stats_register(struct latency_stats *stats)
+{
+	sys_snode_t *prev;
+
+	k_mutex_lock(&stats_list_mutex, K_FOREVER);
+	if (!sys_slist_find(&stats_list, &stats->node, &prev)) {
+		sys_slist_append(&stats_list, &stats->node);
+	}
+	k_mutex_unlock(&stats_list_mutex);
+
+	if (CONFIG_WIFI_LATENCY_TEST_STATS_REPORT_INTERVAL_S > 0) {
+		k_work_schedule(&stats_report_work,
+				K_SECONDS(CONFIG_WIFI_LATENCY_TEST_STATS_REPORT_INTERVAL_S));
+	}
+}
+
+static const char *const stage_names[LATENCY_STAGE_COUNT] = {"prepare", "sendto"};
+
+/* Network stack TX time totals of all interfaces, 0 without NET_PKT_TXTIME_STATS */
+static void stage_stack_get(uint64_t *sum_us, uint32_t *count)
+{
+	*sum_us = 0;
+	*count = 0;
+#if IS_ENABLED(CONFIG_NET_PKT_TXTIME_STATS) && IS_ENABLED(CONFIG_NET_STATISTICS_USER_API)
+	struct net_stats data;
+
+	if (net_mgmt(NET_REQUEST_STATS_GET_ALL, NULL, &data, sizeof(data)) == 0) {
+		*sum_us = data.tx_time.sum;
+		*count = data.tx_time.count;
+	}
+#endif
+}
+
+void latency_stage_init(struct latency_stage_stats *stats, const char *name)
+{
+	memset(stats, 0, sizeof(*stats));
+	stats->name = name;
+	stage_stack_get(&stats->stack_sum_us, &stats->stack_count);
+}
+
+void latency_stage_reset(struct latency_stage_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats->lock);
+
+	memset(stats->hist, 0, sizeof(stats->hist));
+	stage_stack_get(&stats->stack_sum_us, &stats->stack_count);
+
+	k_spin_unlock(&stats->lock, key);
+}
+
+void latency_stage_update(struct latency_stage_stats *stats, uint64_t prep_cycles,
+			  uint64_t send_cycles, uint64_t sent_cycles)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats->lock);
+
+	hist_record(&stats->hist[LATENCY_STAGE_PREPARE],
+		    (uint32_t)k_cyc_to_us_floor64(send_cycles - prep_cycles));
+	hist_record(&stats->hist[LATENCY_STAGE_SEND],
+		    (uint32_t)k_cyc_to_us_floor64(sent_cycles - send_cycles));
+
+	k_spin_unlock(&stats->lock, key);
+}
+
+void latency_stage_print(struct latency_stage_stats *stats)
+{
+	/* count, min, avg, max, p50, p99, p99.9 per stage */
+	uint32_t fig[LATENCY_STAGE_COUNT][7];
+	uint64_t stack_sum_us;
+	uint32_t stack_count;
+	k_spinlock_key_t key;
+
+	stage_stack_get(&stack_sum_us, &stack_count);
+
+	/* The histograms are too large to copy, reduce them under the lock */
+	key = k_spin_lock(&stats->lock);
+	for (int i = 0; i < LATENCY_STAGE_COUNT; i++) {
+		const struct latency_hist *hist = &stats->hist[i];
+
+		fig[i][0] = hist->count;
+		fig[i][1] = hist->min_us;
+		fig[i][2] = hist->count ? (uint32_t)(hist->sum_us / hist->count) : 0;
+		fig[i][3] = hist->max_us;
+		fig[i][4] = hist_percentile(hist, 5000);
+		fig[i][5] = hist_percentile(hist, 9900);
+		fig[i][6] = hist_percentile(hist, 9990);
+	}
+	stack_sum_us -= stats->stack_sum_us;
+	stack_count -= stats->stack_count;
+	k_spin_unlock(&stats->lock, key);
+
+	for (int i = 0; i < LATENCY_STAGE_COUNT; i++) {
+		if (fig[i][0] == 0) {
+			continue;
+		}
+		LOG_INF("[%s] %s us: min %u avg %u max %u p50 %u p99 %u p99.9 %u", stats->name,
+			stage_names[i], fig[i][1], fig[i][2], fig[i][3], fig[i][4], fig[i][5],
+			fig[i][6]);
+	}
+	if (stack_count) {
+		LOG_INF("[%s] net_pkt to driver us: avg %u over %u packets", stats->name,
+			(uint32_t)(stack_sum_us / stack_count), stack_count);
+	}
+}
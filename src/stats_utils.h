@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef STATS_UTILS_H
+#define STATS_UTILS_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/slist.h>
+
+/* Log-linear histogram: 16 linear sub-buckets per power of two (<= 6.25% error),
+ * covering 0 us up to 2^27 us (~134 s). Larger values land in the last bucket.
+ */
+#define LATENCY_HIST_SUB_BITS  4
+#define LATENCY_HIST_SUB_COUNT BIT(LATENCY_HIST_SUB_BITS)
+#define LATENCY_HIST_MAX_BITS  26
+#define LATENCY_HIST_BUCKETS                                                                       \
+	((LATENCY_HIST_MAX_BITS - LATENCY_HIST_SUB_BITS + 2) * LATENCY_HIST_SUB_COUNT)
+
+/* Width of the duplicate/reorder detection window in packets */
+#define LATENCY_SEQ_WINDOW 64
+
+struct latency_hist {
+	uint32_t buckets[LATENCY_HIST_BUCKETS];
+	uint32_t count;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint64_t sum_us;
+};
+
+/* Packet train dispersion tracking */
+struct latency_burst {
+	/* Burst in progress */
+	bool open;
+	uint32_t start_seq;
+	uint8_t frames;
+	uint32_t bytes; /* Received after the first frame */
+	int64_t first_tx_us;
+	int64_t last_tx_us;
+	int64_t first_rx_us;
+	int64_t last_rx_us;
+
+	/* Completed bursts with at least two frames */
+	uint32_t count;
+	uint64_t disp_sum_us;
+	uint32_t disp_max_us;
+	uint64_t tx_disp_sum_us;
+	uint64_t bytes_sum;
+};
+
+/* Radio metadata of the received packets, when the receive path reports it */
+struct latency_link {
+	uint32_t count;
+	int16_t rssi_min_dbm;
+	int16_t rssi_max_dbm;
+	int32_t rssi_sum_dbm;
+	uint8_t rate; /* Last rate and rate flags seen */
+	uint8_t rate_flags;
+	uint32_t rate_changes;
+
+	/* Conditions of the packet with the highest latency so far */
+	uint32_t tail_max_us;
+	int16_t tail_rssi_dbm;
+	uint8_t tail_rate;
+	uint8_t tail_rate_flags;
+};
+
+/* Streaming latency/loss statistics for one packet stream */
+struct latency_stats {
+	sys_snode_t node;
+	const char *name;
+	struct k_spinlock lock;
+
+	/* Sequence tracking */
+	bool seq_valid;
+	uint32_t highest_seq;
+	uint64_t seq_window; /* Bit n set: highest_seq - n was received */
+	uint32_t received;
+	uint32_t lost; /* Gaps not (yet) filled by late packets */
+	uint32_t duplicates;
+	uint32_t reordered;
+
+	/* RFC 3550 inter-arrival jitter, scaled by 16 */
+	bool transit_valid;
+	int64_t last_transit_us;
+	uint64_t jitter_q4;
+
+	/* Sender to local clock mapping; without it latency is relative to the
+	 * transit time of the first packet (delay variation).
+	 */
+	bool clock_offset_valid;
+	int64_t clock_offset_us;
+	int64_t baseline_transit_us;
+
+	/* Goodput */
+	uint64_t bytes;
+	int64_t first_rx_us;
+	int64_t last_rx_us;
+
+	/* Test phase the counters belong to, see latency_stats_set_tag() */
+	uint16_t tag;
+
+	struct latency_hist hist;
+	struct latency_burst burst;
+	struct latency_link link;
+};
+
+/* TX pipeline stages timed on the sender for every packet */
+enum latency_stage {
+	LATENCY_STAGE_PREPARE, /* Packet build to the sendto() call: encoding, copies */
+	LATENCY_STAGE_SEND,    /* sendto() call until it returns */
+	LATENCY_STAGE_COUNT,
+};
+
+/* Per-stage TX latency of one sender */
+struct latency_stage_stats {
+	const char *name;
+	struct k_spinlock lock;
+	struct latency_hist hist[LATENCY_STAGE_COUNT];
+	/* NET_PKT_TXTIME_STATS counters when the window started */
+	uint64_t stack_sum_us;
+	uint32_t stack_count;
+};
+
+/* Snapshot of the derived figures of a statistics instance */
+struct latency_stats_summary {
+	uint32_t received;
+	uint32_t lost;
+	uint32_t duplicates;
+	uint32_t reordered;
+	uint32_t jitter_us;
+	uint32_t goodput_kbps; /* Received bytes over the first to last arrival span */
+	uint16_t tag;
+	uint32_t count;
+	uint32_t min_us;
+	uint32_t avg_us;
+	uint32_t max_us;
+	uint32_t p50_us;
+	uint32_t p90_us;
+	uint32_t p99_us;
+	uint32_t p999_us;
+	bool absolute; /* Latency is one-way/round-trip rather than relative */
+	uint32_t bursts;
+	uint32_t burst_disp_avg_us;
+	uint32_t burst_disp_max_us;
+	uint32_t burst_tx_disp_avg_us;
+	uint32_t burst_rate_kbps; /* Bytes after the first frame over the dispersion */
+	uint32_t link_count; /* Packets with radio metadata, 0 if none reported */
+	int16_t rssi_min_dbm;
+	int16_t rssi_avg_dbm;
+	int16_t rssi_max_dbm;
+	uint8_t rate;
+	uint8_t rate_flags;
+	uint32_t rate_changes;
+	int16_t tail_rssi_dbm; /* RSSI and rate of the max latency packet */
+	uint8_t tail_rate;
+	uint8_t tail_rate_flags;
+};
+
+/**
+ * @brief Initialize a statistics instance
+ *
+ * @param stats Statistics instance
+ * @param name Name printed in summaries, must stay valid
+ */
+void latency_stats_init(struct latency_stats *stats, const char *name);
+
+/**
+ * @brief Clear all counters and the histogram, keeping name and clock offset
+ *
+ * @param stats Statistics instance
+ */
+void latency_stats_reset(struct latency_stats *stats);
+
+/**
+ * @brief Set the offset between the sender clock and the local clock
+ *
+ * Once set, latency is computed as rx_us - (tx_us - offset_us). Use 0 when both
+ * timestamps come from the same clock, e.g. for round-trip measurements.
+ *
+ * @param stats Statistics instance
+ * @param offset_us Sender clock minus local clock in microseconds
+ */
+void latency_stats_set_clock_offset(struct latency_stats *stats, int64_t offset_us);
+
+/**
+ * @brief Record a received packet
+ *
+ * A sequence number LATENCY_SEQ_WINDOW or more below the highest one seen
+ * means the sender started a new session: the counters so far are printed
+ * and reset before the packet is recorded.
+ *
+ * @param stats Statistics instance
+ * @param seq Packet sequence number
+ * @param tx_us TX timestamp from the packet, sender clock
+ * @param rx_us RX timestamp, local clock
+ * @param len Packet length in bytes
+ */
+void latency_stats_update(struct latency_stats *stats, uint32_t seq, int64_t tx_us,
+			  int64_t rx_us, uint16_t len);
+
+/**
+ * @brief Switch the statistics to a new test phase
+ *
+ * When the tag differs from the current one, the summary of the finished
+ * phase is logged and the counters are reset, so every phase (e.g. each
+ * throughput rate step) gets its own goodput, loss and latency figures.
+ *
+ * @param stats Statistics instance
+ * @param tag Phase tag carried by the received packet
+ */
+void latency_stats_set_tag(struct latency_stats *stats, uint16_t tag);
+
+/**
+ * @brief Record the burst position of a received packet
+ *
+ * Call in addition to latency_stats_update() for packets sent in bursts. A
+ * burst is closed by its last frame or by the first frame of the next burst.
+ *
+ * @param stats Statistics instance
+ * @param seq Packet sequence number
+ * @param burst_idx Index of the packet in its burst
+ * @param burst_len Number of packets in the burst
+ * @param len Packet length in bytes
+ * @param tx_us TX timestamp from the packet, sender clock
+ * @param rx_us RX timestamp, local clock
+ */
+void latency_stats_update_burst(struct latency_stats *stats, uint32_t seq, uint8_t burst_idx,
+				uint8_t burst_len, uint16_t len, int64_t tx_us, int64_t rx_us);
+
+/**
+ * @brief Record the radio metadata of a received packet
+ *
+ * Call right after latency_stats_update() for the same packet, so the RSSI
+ * and rate of the highest latency packet can be reported with the tail.
+ *
+ * @param stats Statistics instance
+ * @param rssi_dbm Signal strength in dBm
+ * @param rate Rate the packet was received at, legacy rate or MCS index
+ * @param rate_flags Rate flags reported by the driver
+ */
+void latency_stats_update_link(struct latency_stats *stats, int16_t rssi_dbm, uint8_t rate,
+			       uint8_t rate_flags);
+
+/**
+ * @brief Query a latency percentile
+ *
+ * @param stats Statistics instance
+ * @param per_10k Percentile in hundredths of a percent, e.g. 9990 for p99.9
+ * @return Latency in microseconds, 0 if no samples
+ */
+uint32_t latency_stats_percentile(struct latency_stats *stats, uint32_t per_10k);
+
+/**
+ * @brief Take a consistent snapshot of the derived statistics
+ *
+ * @param stats Statistics instance
+ * @param summary Filled with the snapshot
+ */
+void latency_stats_get_summary(struct latency_stats *stats, struct latency_stats_summary *summary);
+
+/**
+ * @brief Log a one-line summary of a statistics instance
+ *
+ * @param stats Statistics instance
+ */
+void latency_stats_print(struct latency_stats *stats);
+
+/**
+ * @brief Add a statistics instance to the periodic summary report
+ *
+ * The report interval is CONFIG_WIFI_LATENCY_TEST_STATS_REPORT_INTERVAL_S.
+ *
+ * @param stats Statistics instance
+ */
+void latency_stats_register(struct latency_stats *stats);
+
+/**
+ * @brief Initialize a TX stage statistics instance
+ *
+ * @param stats Stage statistics instance
+ * @param name Name printed in summaries, must stay valid
+ */
+void latency_stage_init(struct latency_stage_stats *stats, const char *name);
+
+/**
+ * @brief Clear the stage histograms and start a new network stack window
+ *
+ * @param stats Stage statistics instance
+ */
+void latency_stage_reset(struct latency_stage_stats *stats);
+
+/**
+ * @brief Record the TX stage timestamps of one packet
+ *
+ * All timestamps are k_cycle_get_64() values on the sender.
+ *
+ * @param stats Stage statistics instance
+ * @param prep_cycles Packet build started
+ * @param send_cycles sendto() called
+ * @param sent_cycles sendto() returned
+ */
+void latency_stage_update(struct latency_stage_stats *stats, uint64_t prep_cycles,
+			  uint64_t send_cycles, uint64_t sent_cycles);
+
+/**
+ * @brief Log the per-stage breakdown
+ *
+ * With NET_PKT_TXTIME_STATS the mean time from net_pkt allocation to the
+ * driver hand-off since the last reset is logged as well.
+ *
+ * @param stats Stage statistics instance
+ */
+void latency_stage_print(struct latency_stage_stats *stats);
+
+#endif /* STATS_UTILS_H */
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+#include "sweep_utils.h"
+
+LOG_MODULE_REGISTER(sweep_utils, CONFIG_LOG_DEFAULT_LEVEL);
+
+#define SWEEP_RATE_FLAGS_NUM 5
+#define SWEEP_QUEUE_NUM      5
+
+static const char *const rate_flags_names[SWEEP_RATE_FLAGS_NUM] = {
+	"Legacy", "HT", "VHT", "HE_SU", "HE_ER_SU",
+};
+
+static const char *const queue_names[SWEEP_QUEUE_NUM] = {
+	"BK", "BE", "VI", "VO", "Beacon",
+};
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_SWEEP)
+/* Legacy rate values in CONFIG_WIFI_LATENCY_TEST_SWEEP_LEGACY_RATE_MASK bit order */
+static const uint8_t legacy_rates[] = {1, 2, 55, 11, 6, 9, 12, 18, 24, 36, 48, 54};
+
+static uint32_t sweep_rate_mask(uint8_t rate_flags)
+{
+	return rate_flags == 0 ? CONFIG_WIFI_LATENCY_TEST_SWEEP_LEGACY_RATE_MASK
+			       : CONFIG_WIFI_LATENCY_TEST_SWEEP_MCS_MASK;
+}
+
+static uint8_t sweep_rate_value(uint8_t rate_flags, uint8_t rate_idx)
+{
+	return rate_flags == 0 ? legacy_rates[rate_idx] : rate_idx;
+}
+
+int sweep_get_point(uint32_t idx, const struct test_params *base, struct test_params *point,
+		    uint16_t *tag)
+{
+	uint32_t queues = __builtin_popcount(CONFIG_WIFI_LATENCY_TEST_SWEEP_QUEUE_MASK);
+
+	for (uint8_t flags = 0; flags < SWEEP_RATE_FLAGS_NUM; flags++) {
+		uint32_t rates = sweep_rate_mask(flags);
+		uint32_t points;
+
+		if (!(CONFIG_WIFI_LATENCY_TEST_SWEEP_RATE_FLAGS_MASK & BIT(flags))) {
+			continue;
+		}
+
+		points = __builtin_popcount(rates) * queues;
+		if (idx >= points) {
+			idx -= points;
+			continue;
+		}
+
+		*point = *base;
+		point->raw_rate_flags = flags;
+		point->duration_ms = CONFIG_WIFI_LATENCY_TEST_SWEEP_POINT_DURATION_MS;
+
+		/* idx / queues selects the n-th set rate bit, idx % queues the queue bit */
+		for (uint8_t r = 0, n = idx / queues; r < 32; r++) {
+			if ((rates & BIT(r)) && n-- == 0) {
+				point->raw_rate = sweep_rate_value(flags, r);
+				break;
+			}
+		}
+		for (uint8_t q = 0, n = idx % queues; q < SWEEP_QUEUE_NUM; q++) {
+			if ((CONFIG_WIFI_LATENCY_TEST_SWEEP_QUEUE_MASK & BIT(q)) && n-- == 0) {
+				point->raw_queue = q;
+				break;
+			}
+		}
+
+		*tag = sweep_tag_encode(point->raw_rate, point->raw_rate_flags, point->raw_queue);
+		return 0;
+	}
+
+	return -ENOENT;
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_SWEEP */
+
+/* Best point so far, ranked by p99 latency, then by loss */
+static struct {
+	uint32_t points;
+	bool valid;
+	struct latency_stats_summary best;
+} sweep_result;
+
+static uint32_t sweep_loss_per_mille(const struct latency_stats_summary *summary)
+{
+	uint32_t total = summary->received + summary->lost;
+
+	return total ? summary->lost * 1000U / total : 0;
+}
+
+static void sweep_print_point(const char *prefix, const struct latency_stats_summary *summary)
+{
+	uint8_t rate, rate_flags, queue;
+
+	sweep_tag_decode(summary->tag, &rate, &rate_flags, &queue);
+	LOG_INF("%s rate %u %s queue %s: rx %u loss %u.%u%% p50 %u p99 %u max %u us", prefix,
+		rate, rate_flags < SWEEP_RATE_FLAGS_NUM ? rate_flags_names[rate_flags] : "?",
+		queue < SWEEP_QUEUE_NUM ? queue_names[queue] : "?", summary->received,
+		sweep_loss_per_mille(summary) / 10, sweep_loss_per_mille(summary) % 10,
+		summary->p50_us, summary->p99_us, summary->max_us);
+}
+
+void sweep_record(const struct latency_stats_summary *summary)
+{
+	if (!sweep_tag_is_point(summary->tag)) {
+		return;
+	}
+
+	sweep_result.points++;
+	sweep_print_point("Sweep point", summary);
+	if (summary->count == 0) {
+		return;
+	}
+
+	if (!sweep_result.valid || summary->p99_us < sweep_result.best.p99_us ||
+	    (summary->p99_us == sweep_result.best.p99_us &&
+	     sweep_loss_per_mille(summary) < sweep_loss_per_mille(&sweep_result.best))) {
+		sweep_result.best = *summary;
+		sweep_result.valid = true;
+	}
+}
+
+void sweep_report(void)
+{
+	LOG_INF("Sweep complete: %u points", sweep_result.points);
+	if (sweep_result.valid) {
+		if (!sweep_result.best.absolute) {
+			LOG_WRN("Latency is relative per point, ranking reflects delay variation");
+		}
+		sweep_print_point("Sweep best", &sweep_result.best);
+	}
+
+	memset(&sweep_result, 0, sizeof(sweep_result));
+}
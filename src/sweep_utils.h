@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SWEEP_UTILS_H
+#define SWEEP_UTILS_H
+
+#include <zephyr/kernel.h>
+
+#include "params_utils.h"
+#include "stats_utils.h"
+
+/* Sweep point tags: flag bit, 3-bit rate flags, 3-bit queue, 8-bit rate value.
+ * Throughput step tags stay below SWEEP_TAG_FLAG so the two never collide.
+ */
+#define SWEEP_TAG_FLAG         BIT(15)
+#define SWEEP_TAG_FLAGS_SHIFT  11
+#define SWEEP_TAG_QUEUE_SHIFT  8
+#define SWEEP_TAG_FIELD_MASK   0x7
+#define SWEEP_TAG_RATE_MASK    0xff
+/* Trailer sent after the last point so the receiver can close it */
+#define SWEEP_TAG_END          0xffff
+
+/* Duration and maximum interval of the trailer */
+#define SWEEP_END_DURATION_MS  500
+#define SWEEP_END_INTERVAL_US  50000
+
+static inline uint16_t sweep_tag_encode(uint8_t rate, uint8_t rate_flags, uint8_t queue)
+{
+	return SWEEP_TAG_FLAG | ((rate_flags & SWEEP_TAG_FIELD_MASK) << SWEEP_TAG_FLAGS_SHIFT) |
+	       ((queue & SWEEP_TAG_FIELD_MASK) << SWEEP_TAG_QUEUE_SHIFT) |
+	       (rate & SWEEP_TAG_RATE_MASK);
+}
+
+static inline bool sweep_tag_is_point(uint16_t tag)
+{
+	return (tag & SWEEP_TAG_FLAG) && tag != SWEEP_TAG_END;
+}
+
+static inline void sweep_tag_decode(uint16_t tag, uint8_t *rate, uint8_t *rate_flags,
+				    uint8_t *queue)
+{
+	*rate = tag & SWEEP_TAG_RATE_MASK;
+	*rate_flags = (tag >> SWEEP_TAG_FLAGS_SHIFT) & SWEEP_TAG_FIELD_MASK;
+	*queue = (tag >> SWEEP_TAG_QUEUE_SHIFT) & SWEEP_TAG_FIELD_MASK;
+}
+
+/**
+ * @brief Get a point of the rate/flags/queue sweep
+ *
+ * Points are ordered by rate flags, then rate, then queue, restricted to the
+ * CONFIG_WIFI_LATENCY_TEST_SWEEP_* masks. Each point runs for
+ * CONFIG_WIFI_LATENCY_TEST_SWEEP_POINT_DURATION_MS with the other base values.
+ *
+ * @param idx Point index, starting at 0
+ * @param base Parameters the point is derived from
+ * @param point Filled with the parameters of the point
+ * @param tag Filled with the tag identifying the point on air
+ * @return 0 on success, -ENOENT if idx is past the last point
+ */
+int sweep_get_point(uint32_t idx, const struct test_params *base, struct test_params *point,
+		    uint16_t *tag);
+
+/**
+ * @brief Record the statistics of a finished sweep point on the receiver
+ *
+ * @param summary Statistics of the point, its tag identifies the configuration
+ */
+void sweep_record(const struct latency_stats_summary *summary);
+
+/**
+ * @brief Log the sweep result and clear it for the next sweep
+ */
+void sweep_report(void);
+
+#endif /* SWEEP_UTILS_H */
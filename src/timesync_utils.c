@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/sys/byteorder.h>
+#include <stddef.h>
+
+#include "timesync_utils.h"
+
+LOG_MODULE_REGISTER(timesync_utils, CONFIG_LOG_DEFAULT_LEVEL);
+
+/* Offsets come from the lowest-delay sample of the last TIMESYNC_WINDOW exchanges,
+ * queueing only ever adds delay and asymmetric error.
+ */
+#define TIMESYNC_WINDOW 8
+/* Minimum distance between the samples a drift estimate is taken from */
+#define TIMESYNC_DRIFT_SPAN_US (4LL * USEC_PER_SEC)
+#define TIMESYNC_MSG_LEN       (sizeof(struct latency_probe_hdr) + sizeof(struct timesync_payload))
+
+struct timesync_sample {
+	int64_t local_us;
+	int64_t offset_us;
+	uint32_t delay_us;
+};
+
+/* TX role */
+static struct sockaddr_in timesync_peer;
+static uint32_t timesync_seq;
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_RX)
+#define TIMESYNC_MAX_CLOCKS CONFIG_UDP_RX_DEV_MAX_STATIONS
+#else
+#define TIMESYNC_MAX_CLOCKS 1
+#endif
+
+/* RX role, one estimate per sender so a SoftAP never mixes TX clocks. Only
+ * the RX thread adds clocks and samples, the lock covers the published state.
+ */
+struct timesync_clock {
+	bool used;
+	struct in_addr addr;
+	uint16_t station_id;
+	struct timesync_sample window[TIMESYNC_WINDOW];
+	uint32_t window_count;
+	uint32_t window_next;
+	struct timesync_sample drift_ref;
+	bool drift_valid;
+	bool drift_seen;
+	struct timesync_state state;
+};
+
+static struct timesync_clock timesync_clocks[TIMESYNC_MAX_CLOCKS];
+static bool timesync_clocks_full;
+static struct k_spinlock timesync_lock;
+
+static int64_t timesync_now_us(void)
+{
+	return k_cyc_to_us_floor64(k_cycle_get_64());
+}
+
+static void timesync_payload_get(const uint8_t *buf, struct timesync_payload *ts)
+{
+	const uint8_t *p = buf + sizeof(struct latency_probe_hdr);
+
+	ts->t1 = sys_get_le64(p + offsetof(struct timesync_payload, t1));
+	ts->t2 = sys_get_le64(p + offsetof(struct timesync_payload, t2));
+	ts->t3 = sys_get_le64(p + offsetof(struct timesync_payload, t3));
+	ts->t4 = sys_get_le64(p + offsetof(struct timesync_payload, t4));
+}
+
+static void timesync_payload_put(uint8_t *buf, size_t field_offset, uint64_t value_us)
+{
+	sys_put_le64(value_us, buf + sizeof(struct latency_probe_hdr) + field_offset);
+}
+
+static void timesync_set_flags(uint8_t *buf, uint8_t flags)
+{
+	((struct latency_probe_hdr *)buf)->flags = flags;
+}
+
+int timesync_send_request(int socket, struct sockaddr_in *server_addr)
+{
+	uint8_t buf[TIMESYNC_MSG_LEN];
+	struct latency_probe probe = {
+		.flags = LATENCY_PROBE_FLAG_SYNC_REQ,
+		.payload_len = sizeof(struct timesync_payload),
+		.seq = timesync_seq++,
+	};
+	int ret;
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX)
+	/* The RX device keys its clock estimates by sender */
+	probe.station_id = udp_tx_station_id();
+#endif
+
+	timesync_peer = *server_addr;
+
+	probe.tx_cycles = k_cycle_get_64();
+	ret = udp_probe_encode(buf, sizeof(buf), &probe);
+	if (ret < 0) {
+		return ret;
+	}
+	timesync_payload_put(buf, offsetof(struct timesync_payload, t1),
+			     k_cyc_to_us_floor64(probe.tx_cycles));
+
+	ret = udp_send(socket, server_addr, (const char *)buf, ret);
+	return ret < 0 ? ret : 0;
+}
+
+struct timesync_clock *timesync_clock_get(const struct in_addr *addr, uint16_t station_id)
+{
+	struct timesync_clock *clock = NULL;
+
+	for (int i = 0; i < ARRAY_SIZE(timesync_clocks); i++) {
+		if (!timesync_clocks[i].used) {
+			if (!clock) {
+				clock = &timesync_clocks[i];
+			}
+			continue;
+		}
+		if (timesync_clocks[i].station_id == station_id &&
+		    net_ipv4_addr_cmp(&timesync_clocks[i].addr, addr)) {
+			return &timesync_clocks[i];
+		}
+	}
+
+	if (!clock) {
+		if (!timesync_clocks_full) {
+			LOG_WRN("More than %d senders, the rest report no one-way latency",
+				TIMESYNC_MAX_CLOCKS);
+			timesync_clocks_full = true;
+		}
+		return NULL;
+	}
+
+	*clock = (struct timesync_clock){
+		.addr = *addr,
+		.station_id = station_id,
+	};
+	clock->used = true;
+
+	return clock;
+}
+
+static void timesync_add_sample(struct timesync_clock *clock, const struct timesync_payload *ts)
+{
+	int64_t delay = (int64_t)(ts->t4 - ts->t1) - (int64_t)(ts->t3 - ts->t2);
+	struct timesync_sample sample = {
+		/* Sender minus local clock, assuming a symmetric path */
+		.offset_us = ((int64_t)(ts->t1 - ts->t2) + (int64_t)(ts->t4 - ts->t3)) / 2,
+		.local_us = (int64_t)(ts->t2 + ts->t3) / 2,
+		.delay_us = (uint32_t)CLAMP(delay, 0, UINT32_MAX),
+	};
+	struct timesync_state *state = &clock->state;
+	const struct timesync_sample *best;
+	char addr_str[NET_IPV4_ADDR_LEN];
+	bool first;
+	k_spinlock_key_t key;
+
+	clock->window[clock->window_next] = sample;
+	clock->window_next = (clock->window_next + 1) % TIMESYNC_WINDOW;
+	clock->window_count = MIN(clock->window_count + 1, TIMESYNC_WINDOW);
+
+	best = &clock->window[0];
+	for (uint32_t i = 1; i < clock->window_count; i++) {
+		if (clock->window[i].delay_us < best->delay_us) {
+			best = &clock->window[i];
+		}
+	}
+
+	key = k_spin_lock(&timesync_lock);
+
+	if (!clock->drift_valid) {
+		clock->drift_ref = *best;
+		clock->drift_valid = true;
+	} else if (best->local_us - clock->drift_ref.local_us >= TIMESYNC_DRIFT_SPAN_US) {
+		int64_t ppb = (best->offset_us - clock->drift_ref.offset_us) * NSEC_PER_SEC /
+			      (best->local_us - clock->drift_ref.local_us);
+
+		/* Smooth the estimate, a single sample pair is noisy */
+		if (clock->drift_seen) {
+			ppb = state->drift_ppb + (ppb - state->drift_ppb) / 4;
+		}
+		state->drift_ppb = (int32_t)CLAMP(ppb, INT32_MIN, INT32_MAX);
+		clock->drift_seen = true;
+		clock->drift_ref = *best;
+	}
+
+	first = !state->locked;
+	state->locked = true;
+	state->offset_us = best->offset_us;
+	state->ref_us = best->local_us;
+	state->delay_us = best->delay_us;
+	state->samples++;
+
+	k_spin_unlock(&timesync_lock, key);
+
+	if (first) {
+		net_addr_ntop(AF_INET, &clock->addr, addr_str, sizeof(addr_str));
+		LOG_INF("Clock sync locked to sta%u/%s: offset %lld us, round trip %u us",
+			clock->station_id, addr_str, sample.offset_us, sample.delay_us);
+	} else {
+		LOG_DBG("Sync sample sta%u: offset %lld us, delay %u us, drift %d ppb",
+			clock->station_id, sample.offset_us, sample.delay_us, state->drift_ppb);
+	}
+}
+
+bool timesync_process(int socket, struct sockaddr_in *src_addr, const struct latency_probe *probe,
+		      uint8_t *buf, size_t len, int64_t rx_us)
+{
+	struct timesync_payload ts;
+	int ret;
+
+	if (!(probe->flags & LATENCY_PROBE_FLAG_SYNC_MASK)) {
+		return false;
+	}
+
+	if (probe->payload_len < sizeof(ts)) {
+		LOG_WRN("Dropping short sync message");
+		return true;
+	}
+	timesync_payload_get(buf, &ts);
+
+	if (probe->flags & LATENCY_PROBE_FLAG_SYNC_REQ) {
+		/* RX: answer with the receive time and, as late as possible, the send time */
+		timesync_set_flags(buf, LATENCY_PROBE_FLAG_SYNC_REPLY);
+		timesync_payload_put(buf, offsetof(struct timesync_payload, t2), rx_us);
+		timesync_payload_put(buf, offsetof(struct timesync_payload, t3), timesync_now_us());
+		ret = udp_send(socket, src_addr, (const char *)buf, len);
+	} else if (probe->flags & LATENCY_PROBE_FLAG_SYNC_REPLY) {
+		/* TX: hand all four timestamps to the RX device */
+		timesync_set_flags(buf, LATENCY_PROBE_FLAG_SYNC_FOLLOW_UP);
+		timesync_payload_put(buf, offsetof(struct timesync_payload, t4), rx_us);
+		ret = udp_send(socket, &timesync_peer, (const char *)buf, len);
+	} else {
+		/* RX: the follow-up comes from the sender whose clock it measures */
+		struct timesync_clock *clock = NULL;
+
+		if (src_addr) {
+			clock = timesync_clock_get(&src_addr->sin_addr, probe->station_id);
+		}
+		if (clock) {
+			timesync_add_sample(clock, &ts);
+		}
+		ret = 0;
+	}
+
+	if (ret < 0) {
+		LOG_DBG("Failed to send sync message: %d", ret);
+	}
+	return true;
+}
+
+bool timesync_get_offset(const struct timesync_clock *clock, int64_t local_us,
+			 int64_t *offset_us)
+{
+	k_spinlock_key_t key = k_spin_lock(&timesync_lock);
+	const struct timesync_state *state = &clock->state;
+	bool locked = state->locked;
+
+	if (locked) {
+		*offset_us = state->offset_us +
+			     (local_us - state->ref_us) * state->drift_ppb / (int64_t)NSEC_PER_SEC;
+	}
+
+	k_spin_unlock(&timesync_lock, key);
+	return locked;
+}
+
+void timesync_get_state(const struct timesync_clock *clock, struct timesync_state *state)
+{
+	k_spinlock_key_t key = k_spin_lock(&timesync_lock);
+
+	*state = clock->state;
+
+	k_spin_unlock(&timesync_lock, key);
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef TIMESYNC_UTILS_H
+#define TIMESYNC_UTILS_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+
+#include "udp_utils.h"
+
+/* Two-way time transfer over the probe socket, NTP style:
+ *
+ *   TX --SYNC_REQ(t1)--> RX              t2: RX receive time
+ *   TX <--SYNC_REPLY(t1,t2,t3)-- RX      t3: RX send time, t4: TX receive time
+ *   TX --SYNC_FOLLOW_UP(t1..t4)--> RX
+ *
+ * The RX device estimates the TX clock offset and drift from the follow-ups
+ * and uses them to turn the embedded TX timestamps into one-way latency. It
+ * keeps one estimate per sender, keyed by source address and station ID.
+ */
+
+/* Sync message payload after the probe header, microseconds, little-endian */
+struct timesync_payload {
+	uint64_t t1;
+	uint64_t t2;
+	uint64_t t3;
+	uint64_t t4;
+} __packed;
+
+/* Current estimate of the sender clock relative to the local clock */
+struct timesync_state {
+	bool locked;
+	int64_t offset_us;  /* Sender clock minus local clock at ref_us */
+	int64_t ref_us;     /* Local time of the offset sample */
+	int32_t drift_ppb;  /* Rate of the sender clock relative to the local clock */
+	uint32_t delay_us;  /* Round-trip delay of the sample the offset came from */
+	uint32_t samples;
+};
+
+/* Clock estimate of one sender (RX role) */
+struct timesync_clock;
+
+/**
+ * @brief Send a sync request to the RX device (TX role)
+ *
+ * @param socket UDP client socket, must be able to receive replies
+ * @param server_addr RX device address, also used for the follow-up
+ * @return 0 on success, negative error code on failure
+ */
+int timesync_send_request(int socket, struct sockaddr_in *server_addr);
+
+/**
+ * @brief Handle a received datagram if it is a sync message
+ *
+ * Replies to requests (RX role), sends the follow-up for replies (TX role)
+ * and feeds follow-ups into the offset estimate (RX role).
+ *
+ * @param socket Socket the datagram was received on
+ * @param src_addr Sender of the datagram, NULL on the TX device
+ * @param probe Decoded probe header of the datagram
+ * @param buf Datagram, modified in place for the answer
+ * @param len Length of the datagram
+ * @param rx_us Local receive time in microseconds
+ * @return true if the datagram was a sync message and must not be counted as a probe
+ */
+bool timesync_process(int socket, struct sockaddr_in *src_addr, const struct latency_probe *probe,
+		      uint8_t *buf, size_t len, int64_t rx_us);
+
+/**
+ * @brief Get the clock estimate of a sender, creating it if needed (RX role)
+ *
+ * @param addr Sender address
+ * @param station_id Station ID carried in the sender's probes
+ * @return Clock of the sender, NULL if CONFIG_UDP_RX_DEV_MAX_STATIONS senders
+ *         are already tracked
+ */
+struct timesync_clock *timesync_clock_get(const struct in_addr *addr, uint16_t station_id);
+
+/**
+ * @brief Get a sender's clock offset extrapolated to a local time (RX role)
+ *
+ * @param clock Clock of the sender
+ * @param local_us Local time in microseconds
+ * @param offset_us Filled with sender clock minus local clock
+ * @return true if the clocks are synchronized
+ */
+bool timesync_get_offset(const struct timesync_clock *clock, int64_t local_us,
+			 int64_t *offset_us);
+
+/**
+ * @brief Get a copy of a sender's current estimate (RX role)
+ *
+ * @param clock Clock of the sender
+ * @param state Filled with the estimate
+ */
+void timesync_get_state(const struct timesync_clock *clock, struct timesync_state *state);
+
+#endif /* TIMESYNC_UTILS_H */
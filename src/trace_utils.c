@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/printk.h>
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRACE_OUTPUT_RTT)
+#include <SEGGER_RTT.h>
+#endif
+
+#include "trace_utils.h"
+
+LOG_MODULE_REGISTER(trace_utils, CONFIG_LOG_DEFAULT_LEVEL);
+
+#define TRACE_RING_SIZE      CONFIG_WIFI_LATENCY_TEST_TRACE_RING_RECORDS
+#define TRACE_DRAIN_STACK    1024
+#define TRACE_DRAIN_PRIORITY K_LOWEST_APPLICATION_THREAD_PRIO
+#define TRACE_DRAIN_BATCH    16
+
+BUILD_ASSERT(IS_POWER_OF_TWO(TRACE_RING_SIZE), "Trace ring size must be a power of two");
+
+/* Single-producer/single-consumer ring. Head is only written by the producer
+ * and tail only by the drain thread, so no lock is needed.
+ */
+struct trace_ring {
+	struct trace_record records[TRACE_RING_SIZE];
+	atomic_t head;
+	atomic_t tail;
+};
+
+static struct trace_ring tx_ring;
+/* The UDP RX (or echo) thread and the raw consumer thread run side by side in
+ * an interleaved image, each gets its own RX ring.
+ */
+static struct trace_ring rx_udp_ring;
+static struct trace_ring rx_raw_ring;
+static atomic_t trace_dropped;
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRACE_OUTPUT_RTT)
+static uint8_t rtt_up_buf[CONFIG_WIFI_LATENCY_TEST_TRACE_RTT_BUFFER_SIZE];
+#endif
+
+static struct trace_ring *trace_ring_get(enum trace_event event, uint8_t stream)
+{
+	if (!TRACE_EVT_IS_RX(event)) {
+		return &tx_ring;
+	}
+	return stream == TRACE_STREAM_RAW ? &rx_raw_ring : &rx_udp_ring;
+}
+
+void trace_utils_record(enum trace_event event, uint8_t stream, uint32_t seq, uint64_t cycles,
+			int8_t rssi, uint16_t len)
+{
+	struct trace_ring *ring = trace_ring_get(event, stream);
+	uint32_t head = (uint32_t)atomic_get(&ring->head);
+	struct trace_record *rec;
+
+	if (head - (uint32_t)atomic_get(&ring->tail) >= TRACE_RING_SIZE) {
+		atomic_inc(&trace_dropped);
+		return;
+	}
+
+	rec = &ring->records[head & (TRACE_RING_SIZE - 1)];
+	rec->cycles = cycles;
+	rec->seq = seq;
+	rec->len = len;
+	rec->event = event;
+	rec->rssi = rssi;
+	rec->stream = stream;
+
+	/* Publish the record */
+	atomic_set(&ring->head, head + 1);
+}
+
+uint32_t trace_utils_dropped(void)
+{
+	return (uint32_t)atomic_get(&trace_dropped);
+}
+
+static void trace_output(const struct trace_record *recs, size_t count)
+{
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRACE_OUTPUT_RTT)
+	SEGGER_RTT_Write(CONFIG_WIFI_LATENCY_TEST_TRACE_RTT_CHANNEL, recs, count * sizeof(*recs));
+#else
+	for (size_t i = 0; i < count; i++) {
+		printk("trace,%u,%u,%u,%llu,%d,%u\n", recs[i].event, recs[i].stream, recs[i].seq,
+		       recs[i].cycles, recs[i].rssi, recs[i].len);
+	}
+#endif
+}
+
+/* Returns the number of records drained */
+static size_t trace_drain_ring(struct trace_ring *ring)
+{
+	struct trace_record batch[TRACE_DRAIN_BATCH];
+	uint32_t tail = (uint32_t)atomic_get(&ring->tail);
+	uint32_t head = (uint32_t)atomic_get(&ring->head);
+	size_t count = MIN(head - tail, TRACE_DRAIN_BATCH);
+
+	for (size_t i = 0; i < count; i++) {
+		batch[i] = ring->records[(tail + i) & (TRACE_RING_SIZE - 1)];
+	}
+
+	/* Release the slots before the slow output */
+	atomic_set(&ring->tail, tail + count);
+
+	if (count) {
+		trace_output(batch, count);
+	}
+	return count;
+}
+
+static void trace_drain_thread(void *p1, void *p2, void *p3)
+{
+	uint32_t reported_dropped = 0;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRACE_OUTPUT_RTT)
+	SEGGER_RTT_ConfigUpBuffer(CONFIG_WIFI_LATENCY_TEST_TRACE_RTT_CHANNEL, "latency_trace",
+				  rtt_up_buf, sizeof(rtt_up_buf), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+#endif
+
+	while (1) {
+		uint32_t dropped;
+		size_t drained;
+
+		/* Drain in bulk, then sleep until the next period */
+		do {
+			drained = trace_drain_ring(&tx_ring);
+			drained += trace_drain_ring(&rx_udp_ring);
+			drained += trace_drain_ring(&rx_raw_ring);
+		} while (drained > 0);
+
+		dropped = trace_utils_dropped();
+		if (dropped != reported_dropped) {
+			LOG_WRN("Trace ring full, %u records dropped", dropped);
+			reported_dropped = dropped;
+		}
+
+		k_sleep(K_MSEC(CONFIG_WIFI_LATENCY_TEST_TRACE_DRAIN_INTERVAL_MS));
+	}
+}
+
+K_THREAD_DEFINE(trace_drain_tid, TRACE_DRAIN_STACK, trace_drain_thread, NULL, NULL, NULL,
+		TRACE_DRAIN_PRIORITY, 0, 0);
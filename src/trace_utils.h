@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef TRACE_UTILS_H
+#define TRACE_UTILS_H
+
+#include <zephyr/kernel.h>
+
+/* Trace event identifiers. TX events go to one ring and RX events to one ring
+ * per transport, each ring must only be written from a single thread.
+ */
+enum trace_event {
+	TRACE_EVT_TX = 1,   /* Packet handed to the stack */
+	TRACE_EVT_TX_ERR,   /* Send failed, len carries the negated error */
+	TRACE_EVT_TX_SENT,  /* sendto() returned, see CONFIG_WIFI_LATENCY_TEST_TX_STAGES */
+	TRACE_EVT_RX = 16,  /* Test packet received */
+	TRACE_EVT_ECHO_RX,  /* Echo reply received */
+};
+
+#define TRACE_EVT_IS_RX(evt) ((evt) >= TRACE_EVT_RX)
+
+/* Transport of a record: UDP streams by WMM access category, then raw */
+#define TRACE_STREAM_UDP(ac) ((uint8_t)(ac))
+#define TRACE_STREAM_RAW     4
+
+/* Fixed-size binary trace record, also the RTT wire format (little-endian) */
+struct trace_record {
+	uint64_t cycles; /* k_cycle_get_64() at the event */
+	uint32_t seq;
+	uint16_t len;
+	uint8_t event;
+	int8_t rssi;    /* dBm, 0 if unknown */
+	uint8_t stream; /* TRACE_STREAM_* of the transport */
+} __packed;
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRACE)
+/**
+ * @brief Record a trace event without blocking
+ *
+ * The record is dropped and counted if the ring is full.
+ *
+ * @param event Event identifier
+ * @param stream Transport of the packet, see TRACE_STREAM_RAW and TRACE_STREAM_UDP()
+ * @param seq Packet sequence number
+ * @param cycles Cycle counter timestamp of the event
+ * @param rssi Signal strength in dBm, 0 if unknown
+ * @param len Packet length
+ */
+void trace_utils_record(enum trace_event event, uint8_t stream, uint32_t seq, uint64_t cycles,
+			int8_t rssi, uint16_t len);
+
+/**
+ * @brief Get the number of records dropped because a ring was full
+ *
+ * @return Number of dropped records
+ */
+uint32_t trace_utils_dropped(void);
+#else
+static inline void trace_utils_record(enum trace_event event, uint8_t stream, uint32_t seq,
+				      uint64_t cycles, int8_t rssi, uint16_t len)
+{
+}
+
+static inline uint32_t trace_utils_dropped(void)
+{
+	return 0;
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_TRACE */
+
+#endif /* TRACE_UTILS_H */
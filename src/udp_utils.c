@@ -6,13 +6,32 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/ptp_time.h>
 #include <zephyr/net/socket.h>
 #include <zephyr/posix/arpa/inet.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
 
+#include "boot_utils.h"
+#include "led_utils.h"
+#include "net_event_mgmt_utils.h"
+#include "pool_utils.h"
+#include "ps_utils.h"
+#include "stats_utils.h"
+#include "timesync_utils.h"
+#include "trace_utils.h"
 #include "udp_utils.h"
 
 LOG_MODULE_REGISTER(udp_utils, CONFIG_LOG_DEFAULT_LEVEL);
 
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_RX)
+#define UDP_RX_BATCH_MAX CONFIG_UDP_RX_DEV_BATCH_MAX
+#else
+#define UDP_RX_BATCH_MAX 1
+#endif
+
 int udp_client_init(int *socket, struct sockaddr_in *server_addr, const char *target_ip,
 		    uint16_t port)
 {
@@ -42,6 +61,55 @@ int udp_client_init(int *socket, struct sockaddr_in *server_addr, const char *ta
 	return 0;
 }
 
+/* DSCP per access category. The class selector bits double as IP precedence,
+ * which the driver maps to the user priority: CS1 -> UP 1 (BK), 0 -> UP 0
+ * (BE), AF41 -> UP 4 (VI), CS6 -> UP 6 (VO).
+ */
+static const struct {
+	const char *name;
+	uint8_t dscp;
+	uint8_t priority;
+} udp_ac_map[UDP_AC_COUNT] = {
+	[UDP_AC_BK] = {"BK", 8, NET_PRIORITY_BK},
+	[UDP_AC_BE] = {"BE", 0, NET_PRIORITY_BE},
+	[UDP_AC_VI] = {"VI", 34, NET_PRIORITY_VI},
+	[UDP_AC_VO] = {"VO", 48, NET_PRIORITY_VO},
+};
+
+const char *udp_ac_name(uint8_t ac)
+{
+	return ac < UDP_AC_COUNT ? udp_ac_map[ac].name : "??";
+}
+
+int udp_client_set_ac(int socket, uint8_t ac)
+{
+	uint8_t priority;
+	uint8_t tos;
+	int ret;
+
+	if (ac >= UDP_AC_COUNT) {
+		return -EINVAL;
+	}
+	priority = udp_ac_map[ac].priority;
+	tos = udp_ac_map[ac].dscp << 2;
+
+	ret = zsock_setsockopt(socket, SOL_SOCKET, SO_PRIORITY, &priority, sizeof(priority));
+	if (ret < 0) {
+		LOG_ERR("Failed to set socket priority: %d", errno);
+		return -errno;
+	}
+
+	ret = zsock_setsockopt(socket, IPPROTO_IP, IP_TOS, &tos, sizeof(tos));
+	if (ret < 0) {
+		LOG_ERR("Failed to set DSCP: %d", errno);
+		return -errno;
+	}
+
+	LOG_INF("UDP socket mapped to AC %s (DSCP %u, priority %u)", udp_ac_map[ac].name,
+		udp_ac_map[ac].dscp, priority);
+	return 0;
+}
+
 int udp_server_init(int *socket, uint16_t port)
 {
 	int sock;
@@ -90,11 +158,17 @@ int udp_send(int socket, struct sockaddr_in *server_addr, const char *data, size
 int udp_receive(int socket, char *buffer, size_t buffer_size)
 {
 	struct sockaddr_in client_addr;
-	socklen_t client_addr_len = sizeof(client_addr);
+
+	return udp_receive_from(socket, buffer, buffer_size, &client_addr);
+}
+
+int udp_receive_from(int socket, char *buffer, size_t buffer_size, struct sockaddr_in *src_addr)
+{
+	socklen_t src_addr_len = sizeof(*src_addr);
 	int ret;
 
-	ret = zsock_recvfrom(socket, buffer, buffer_size - 1, 0, (struct sockaddr *)&client_addr,
-			     &client_addr_len);
+	ret = zsock_recvfrom(socket, buffer, buffer_size - 1, 0, (struct sockaddr *)src_addr,
+			     &src_addr_len);
 	if (ret < 0) {
 		if (errno == EAGAIN || errno == EWOULDBLOCK) {
 			/* Timeout or would block - not an error */
@@ -107,6 +181,216 @@ int udp_receive(int socket, char *buffer, size_t buffer_size)
 	return ret;
 }
 
+int udp_server_enable_timestamps(int socket)
+{
+#if IS_ENABLED(CONFIG_UDP_RX_DEV_RX_TIMESTAMPING)
+	uint8_t timestamping = SOF_TIMESTAMPING_RX_HARDWARE;
+	int ret;
+
+	ret = zsock_setsockopt(socket, SOL_SOCKET, SO_TIMESTAMPING, &timestamping,
+			       sizeof(timestamping));
+	if (ret < 0) {
+		LOG_ERR("Failed to enable RX timestamps: %d", errno);
+		return -errno;
+	}
+#else
+	ARG_UNUSED(socket);
+#endif
+	return 0;
+}
+
+#if IS_ENABLED(CONFIG_UDP_RX_DEV_RX_TIMESTAMPING)
+/* Stack timestamp of a datagram, false if the driver left it unset */
+static bool udp_rx_stack_timestamp(struct msghdr *msg, uint64_t *rx_cycles)
+{
+	for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(msg); cmsg; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+		struct net_ptp_time ts;
+		uint64_t ns;
+
+		if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SO_TIMESTAMPING) {
+			continue;
+		}
+
+		memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+		ns = ts.second * NSEC_PER_SEC + ts.nanosecond;
+		if (ns == 0) {
+			return false;
+		}
+
+		*rx_cycles = k_ns_to_cyc_floor64(ns);
+		return true;
+	}
+
+	return false;
+}
+#endif
+
+int udp_receive_batch(int socket, uint8_t *buf, size_t buf_size, int timeout_ms,
+		      udp_rx_handler_t handler, void *user_data)
+{
+	struct zsock_pollfd fds = {
+		.fd = socket,
+		.events = ZSOCK_POLLIN,
+	};
+	struct udp_rx_datagram dgram = {
+		.buf = buf,
+	};
+	struct iovec iov = {
+		.iov_base = buf,
+		.iov_len = buf_size,
+	};
+#if IS_ENABLED(CONFIG_UDP_RX_DEV_RX_TIMESTAMPING)
+	uint8_t control[CMSG_SPACE(sizeof(struct net_ptp_time))];
+#endif
+	struct msghdr msg;
+	int handled = 0;
+	int ret;
+
+	ret = zsock_poll(&fds, 1, timeout_ms);
+	if (ret < 0) {
+		LOG_ERR("Failed to poll UDP socket: %d", errno);
+		return -errno;
+	}
+	if (ret == 0) {
+		return 0;
+	}
+
+	while (handled < UDP_RX_BATCH_MAX) {
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_name = &dgram.src;
+		msg.msg_namelen = sizeof(dgram.src);
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+#if IS_ENABLED(CONFIG_UDP_RX_DEV_RX_TIMESTAMPING)
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+#endif
+
+		ret = zsock_recvmsg(socket, &msg, ZSOCK_MSG_DONTWAIT);
+		/* Stamp before anything else, the queue may hold more */
+		dgram.rx_cycles = k_cycle_get_64();
+		if (ret < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				break;
+			}
+			LOG_ERR("Failed to receive UDP data: %d", errno);
+			return handled ? handled : -errno;
+		}
+
+		dgram.len = ret;
+		dgram.stack_ts = false;
+#if IS_ENABLED(CONFIG_UDP_RX_DEV_RX_TIMESTAMPING)
+		dgram.stack_ts = udp_rx_stack_timestamp(&msg, &dgram.rx_cycles);
+#endif
+		handler(socket, &dgram, user_data);
+		handled++;
+	}
+
+	return handled;
+}
+
+#ifdef CONFIG_NRF70_TX_MAX_DATA_SIZE
+/* IPv4 and UDP headers go in front of the probe */
+BUILD_ASSERT(LATENCY_PROBE_MAX_LEN + 28 <= CONFIG_NRF70_TX_MAX_DATA_SIZE,
+	     "WIFI_LATENCY_TEST_PAYLOAD_SIZE exceeds NRF70_TX_MAX_DATA_SIZE");
+#endif
+
+int udp_probe_encode(uint8_t *buf, size_t buf_size, const struct latency_probe *probe)
+{
+	struct latency_probe_hdr *hdr = (struct latency_probe_hdr *)buf;
+	size_t total_len = sizeof(*hdr) + probe->payload_len;
+
+	if (buf_size < total_len) {
+		return -ENOBUFS;
+	}
+
+	sys_put_le32(LATENCY_PROBE_MAGIC, (uint8_t *)&hdr->magic);
+	hdr->version = LATENCY_PROBE_VERSION;
+	hdr->flags = probe->flags;
+	sys_put_le16(probe->payload_len, (uint8_t *)&hdr->payload_len);
+	sys_put_le32(probe->seq, (uint8_t *)&hdr->seq);
+	sys_put_le64(probe->tx_cycles, (uint8_t *)&hdr->tx_cycles);
+	hdr->burst_idx = probe->burst_idx;
+	hdr->burst_len = probe->burst_len;
+	sys_put_le16(probe->tag, (uint8_t *)&hdr->tag);
+	sys_put_le16(probe->station_id, (uint8_t *)&hdr->station_id);
+	hdr->ac = probe->ac;
+	memset(buf + sizeof(*hdr), 0, probe->payload_len);
+
+	return total_len;
+}
+
+int udp_probe_decode(const uint8_t *buf, size_t len, struct latency_probe *probe)
+{
+	const struct latency_probe_hdr *hdr = (const struct latency_probe_hdr *)buf;
+
+	if (len < sizeof(*hdr)) {
+		return -EMSGSIZE;
+	}
+
+	if (sys_get_le32((const uint8_t *)&hdr->magic) != LATENCY_PROBE_MAGIC ||
+	    hdr->version != LATENCY_PROBE_VERSION) {
+		return -EBADMSG;
+	}
+
+	probe->flags = hdr->flags;
+	probe->payload_len = sys_get_le16((const uint8_t *)&hdr->payload_len);
+	probe->seq = sys_get_le32((const uint8_t *)&hdr->seq);
+	probe->tx_cycles = sys_get_le64((const uint8_t *)&hdr->tx_cycles);
+	probe->burst_idx = hdr->burst_idx;
+	probe->burst_len = hdr->burst_len;
+	probe->tag = sys_get_le16((const uint8_t *)&hdr->tag);
+	probe->station_id = sys_get_le16((const uint8_t *)&hdr->station_id);
+	probe->ac = hdr->ac;
+
+	if (len < sizeof(*hdr) + probe->payload_len) {
+		return -EMSGSIZE;
+	}
+
+	return 0;
+}
+
+int udp_client_enable_replies(int socket, int timeout_ms)
+{
+	struct sockaddr_in local_addr = {
+		.sin_family = AF_INET,
+		.sin_addr.s_addr = INADDR_ANY,
+		.sin_port = 0,
+	};
+	struct timeval timeout = {
+		.tv_sec = timeout_ms / 1000,
+		.tv_usec = (timeout_ms % 1000) * 1000,
+	};
+	int ret;
+
+	ret = zsock_bind(socket, (struct sockaddr *)&local_addr, sizeof(local_addr));
+	if (ret < 0) {
+		LOG_ERR("Failed to bind UDP client socket: %d", errno);
+		return -errno;
+	}
+
+	ret = zsock_setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	if (ret < 0) {
+		LOG_ERR("Failed to set UDP receive timeout: %d", errno);
+		return -errno;
+	}
+
+	return 0;
+}
+
+int udp_probe_echo(int socket, struct sockaddr_in *dst_addr, uint8_t *buf, size_t len)
+{
+	struct latency_probe_hdr *hdr = (struct latency_probe_hdr *)buf;
+
+	if (len < sizeof(*hdr)) {
+		return -EMSGSIZE;
+	}
+
+	hdr->flags = (hdr->flags & ~LATENCY_PROBE_FLAG_ECHO_REQ) | LATENCY_PROBE_FLAG_ECHO_REPLY;
+
+	return udp_send(socket, dst_addr, (const char *)buf, len);
+}
+
 void udp_client_cleanup(int socket)
 {
 	if (socket >= 0) {
@@ -122,3 +406,586 @@ void udp_server_cleanup(int socket)
 		LOG_INF("UDP server socket closed");
 	}
 }
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX)
+/* Station ID in every probe, from Kconfig or the Wi-Fi MAC address */
+uint16_t udp_tx_station_id(void)
+{
+#ifdef CONFIG_UDP_TX_DEV_STATION_ID
+	static uint16_t station_id = CONFIG_UDP_TX_DEV_STATION_ID;
+#else
+	static uint16_t station_id;
+#endif
+
+	if (station_id == 0) {
+		struct net_if *iface = net_if_get_first_wifi();
+		struct net_linkaddr *link = iface ? net_if_get_link_addr(iface) : NULL;
+
+		if (link && link->len >= 2) {
+			station_id = sys_get_be16(&link->addr[link->len - 2]);
+		}
+	}
+
+	return station_id;
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX */
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRANSPORT_UDP) &&                                          \
+	IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX)
+
+/* Replies reach the TX socket for the echo mode and for clock synchronization */
+#define UDP_TX_REPLY_RX                                                                            \
+	(IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_UDP_ECHO) ||                                          \
+	 IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TIMESYNC))
+
+#if UDP_TX_REPLY_RX
+#define UDP_ECHO_RX_STACK_SIZE 2048
+#define UDP_ECHO_RX_PRIORITY   K_PRIO_PREEMPT(0)
+#define UDP_ECHO_RX_TIMEOUT_MS 100
+
+static K_SEM_DEFINE(echo_rx_start_sem, 0, 1);
+static K_SEM_DEFINE(echo_rx_done_sem, 0, 1);
+static atomic_t echo_rx_active;
+static int echo_rx_socket = -1;
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_UDP_ECHO)
+static struct latency_stats udp_rtt_stats;
+#endif
+
+/* Receives echo replies on the TX socket so replies are timestamped as soon as
+ * they arrive, independent of the TX pacing.
+ */
+static void udp_echo_rx_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		k_sem_take(&echo_rx_start_sem, K_FOREVER);
+
+		while (atomic_get(&echo_rx_active)) {
+			static char buffer[MAX(256, LATENCY_PROBE_MAX_LEN)];
+			struct latency_probe probe;
+			uint64_t rx_cycles;
+			int ret;
+
+			ret = udp_receive(echo_rx_socket, buffer, sizeof(buffer));
+			if (ret <= 0) {
+				/* Timeout, check whether the session is still active */
+				continue;
+			}
+			rx_cycles = k_cycle_get_64();
+
+			if (udp_probe_decode((const uint8_t *)buffer, ret, &probe)) {
+				continue;
+			}
+
+			if (IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TIMESYNC) &&
+			    timesync_process(echo_rx_socket, NULL, &probe, (uint8_t *)buffer, ret,
+					     k_cyc_to_us_floor64(rx_cycles))) {
+				continue;
+			}
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_UDP_ECHO)
+			if (!(probe.flags & LATENCY_PROBE_FLAG_ECHO_REPLY)) {
+				continue;
+			}
+
+			latency_stats_set_tag(&udp_rtt_stats, probe.tag);
+			latency_stats_update(&udp_rtt_stats, probe.seq,
+					     k_cyc_to_us_floor64(probe.tx_cycles),
+					     k_cyc_to_us_floor64(rx_cycles), ret);
+			if (probe.burst_len > 1) {
+				latency_stats_update_burst(&udp_rtt_stats, probe.seq,
+							   probe.burst_idx, probe.burst_len, ret,
+							   k_cyc_to_us_floor64(probe.tx_cycles),
+							   k_cyc_to_us_floor64(rx_cycles));
+			}
+			if (IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRACE)) {
+				trace_utils_record(TRACE_EVT_ECHO_RX, TRACE_STREAM_UDP(probe.ac),
+						   probe.seq, rx_cycles, 0, ret);
+			} else if (!IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_THROUGHPUT)) {
+				LOG_INF("Echo: seq %u RTT %llu us", probe.seq,
+					k_cyc_to_us_floor64(rx_cycles - probe.tx_cycles));
+			}
+#endif /* CONFIG_WIFI_LATENCY_TEST_UDP_ECHO */
+		}
+
+		k_sem_give(&echo_rx_done_sem);
+	}
+}
+
+K_THREAD_DEFINE(udp_echo_rx_tid, UDP_ECHO_RX_STACK_SIZE, udp_echo_rx_thread, NULL, NULL, NULL,
+		UDP_ECHO_RX_PRIORITY, 0, 0);
+
+static int udp_echo_rx_start(int udp_socket)
+{
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_UDP_ECHO)
+	static bool rtt_stats_ready;
+#endif
+	int ret;
+
+	ret = udp_client_enable_replies(udp_socket, UDP_ECHO_RX_TIMEOUT_MS);
+	if (ret) {
+		return ret;
+	}
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_UDP_ECHO)
+	if (!rtt_stats_ready) {
+		latency_stats_init(&udp_rtt_stats, "udp-rtt");
+		/* Both timestamps come from the local clock */
+		latency_stats_set_clock_offset(&udp_rtt_stats, 0);
+		latency_stats_register(&udp_rtt_stats);
+		rtt_stats_ready = true;
+	} else {
+		latency_stats_reset(&udp_rtt_stats);
+	}
+#endif
+	echo_rx_socket = udp_socket;
+	atomic_set(&echo_rx_active, 1);
+	k_sem_give(&echo_rx_start_sem);
+	return 0;
+}
+
+static void udp_echo_rx_stop(void)
+{
+	/* Give late replies one receive timeout to arrive */
+	atomic_set(&echo_rx_active, 0);
+	k_sem_take(&echo_rx_done_sem, K_FOREVER);
+	echo_rx_socket = -1;
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_UDP_ECHO)
+	latency_stats_print(&udp_rtt_stats);
+#endif
+}
+#endif /* UDP_TX_REPLY_RX */
+
+#if IS_ENABLED(CONFIG_UDP_TX_DEV_WMM)
+#define UDP_TX_AC_MASK CONFIG_UDP_TX_DEV_AC_MASK
+#else
+#define UDP_TX_AC_MASK BIT(UDP_AC_BE)
+#endif
+
+/* One probe stream: its own socket, access category and sequence space, so
+ * the RX device counts losses per category. The engine keeps the sequence
+ * numbers; only the primary stream asks for echoes and syncs the clocks.
+ */
+struct udp_tx_stream {
+	int socket;
+	struct sockaddr_in server_addr;
+	uint16_t payload_len;
+	uint8_t ac;
+	bool primary;
+	int64_t next_sync_ms;
+};
+
+static struct udp_tx_stream udp_tx_streams[UDP_AC_COUNT];
+static struct latency_transport udp_tx_transports[UDP_AC_COUNT];
+static int udp_tx_stream_count;
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TIMESYNC)
+#define TIMESYNC_WARMUP_REQUESTS   8
+#define TIMESYNC_WARMUP_SPACING_MS 20
+
+/* Lock the receiver onto the TX clock before the first probe */
+static void udp_timesync_warmup(struct udp_tx_stream *stream)
+{
+	for (int i = 0; i < TIMESYNC_WARMUP_REQUESTS && !engine_stopping(); i++) {
+		timesync_send_request(stream->socket, &stream->server_addr);
+		k_sleep(K_MSEC(TIMESYNC_WARMUP_SPACING_MS));
+	}
+	stream->next_sync_ms = k_uptime_get() + CONFIG_WIFI_LATENCY_TEST_TIMESYNC_INTERVAL_MS;
+}
+
+/* Keep tracking offset and drift during the session */
+static void udp_timesync_poll(struct udp_tx_stream *stream)
+{
+	int64_t now = k_uptime_get();
+
+	if (now >= stream->next_sync_ms) {
+		timesync_send_request(stream->socket, &stream->server_addr);
+		stream->next_sync_ms = now + CONFIG_WIFI_LATENCY_TEST_TIMESYNC_INTERVAL_MS;
+	}
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_TIMESYNC */
+
+/* The primary stream owns the reply path of the session */
+static int udp_tx_primary_init(struct udp_tx_stream *stream)
+{
+	if (IS_ENABLED(CONFIG_UDP_TX_DEV_WMM)) {
+		LOG_INF("Sending %d WMM streams, access category mask 0x%x", udp_tx_stream_count,
+			UDP_TX_AC_MASK);
+	}
+
+#if UDP_TX_REPLY_RX
+	int ret = udp_echo_rx_start(stream->socket);
+
+	if (ret) {
+		LOG_ERR("Failed to prepare echo reception: %d", ret);
+		return ret;
+	}
+	pool_monitor_set_socket(stream->socket);
+#endif
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TIMESYNC)
+	udp_timesync_warmup(stream);
+#endif
+	return 0;
+}
+
+static int udp_transport_init(struct latency_transport *transport, const struct test_params *params)
+{
+	struct udp_tx_stream *stream = transport->ctx;
+	int ret;
+
+	ret = udp_client_init(&stream->socket, &stream->server_addr, params->target_ip,
+			      CONFIG_WIFI_LATENCY_TEST_SOCKET_PORT);
+	if (ret) {
+		return ret;
+	}
+	stream->payload_len = params->payload_size;
+
+	if (IS_ENABLED(CONFIG_UDP_TX_DEV_WMM)) {
+		ret = udp_client_set_ac(stream->socket, stream->ac);
+	}
+	if (!ret && stream->primary) {
+		ret = udp_tx_primary_init(stream);
+	}
+	if (ret) {
+		udp_client_cleanup(stream->socket);
+		stream->socket = -1;
+	}
+
+	return ret;
+}
+
+static int udp_transport_send(struct latency_transport *transport, const struct engine_pkt *pkt,
+			      struct engine_sent *sent)
+{
+	static uint8_t payload[LATENCY_PROBE_MAX_LEN];
+	struct udp_tx_stream *stream = transport->ctx;
+	struct latency_probe probe = {
+		.flags = IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_UDP_ECHO) && stream->primary
+				 ? LATENCY_PROBE_FLAG_ECHO_REQ
+				 : 0,
+		.payload_len = stream->payload_len,
+		.seq = pkt->seq,
+		.burst_idx = pkt->burst_idx,
+		.burst_len = pkt->burst_len,
+		.tag = pkt->tag,
+		.station_id = udp_tx_station_id(),
+		.ac = stream->ac,
+	};
+	int payload_len;
+	int ret;
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TIMESYNC)
+	if (stream->primary && pkt->burst_idx == 0) {
+		udp_timesync_poll(stream);
+	}
+#endif
+
+	/* Prepare binary probe with sequence number and TX timestamp */
+	probe.tx_cycles = k_cycle_get_64();
+	payload_len = udp_probe_encode(payload, sizeof(payload), &probe);
+	if (payload_len < 0) {
+		return payload_len;
+	}
+
+	/* Send UDP packet */
+	sent->send_cycles = k_cycle_get_64();
+	ret = udp_send(stream->socket, &stream->server_addr, (const char *)payload, payload_len);
+	sent->sent_cycles = k_cycle_get_64();
+	if (ret < 0) {
+		return ret;
+	}
+	sent->tx_cycles = probe.tx_cycles;
+	sent->prep_cycles = probe.tx_cycles;
+	sent->len = payload_len;
+
+	return 0;
+}
+
+static void udp_transport_cleanup(struct latency_transport *transport)
+{
+	struct udp_tx_stream *stream = transport->ctx;
+
+#if UDP_TX_REPLY_RX
+	if (stream->primary) {
+		udp_echo_rx_stop();
+		pool_monitor_set_socket(-1);
+	}
+#endif
+	udp_client_cleanup(stream->socket);
+	stream->socket = -1;
+}
+
+static const struct latency_transport_api udp_transport_api = {
+	.init = udp_transport_init,
+	.send = udp_transport_send,
+	.cleanup = udp_transport_cleanup,
+};
+
+BUILD_ASSERT(UDP_AC_COUNT <= TRACE_STREAM_RAW, "UDP trace streams overlap the raw one");
+
+static const char *const udp_tx_stream_names[UDP_AC_COUNT] = {
+	"UDP/BK", "UDP/BE", "UDP/VI", "UDP/VO",
+};
+
+int udp_transports_get(struct latency_transport **transports, int max)
+{
+	int count = 0;
+
+	for (uint8_t ac = 0; ac < UDP_AC_COUNT && count < max; ac++) {
+		struct udp_tx_stream *stream = &udp_tx_streams[count];
+		struct latency_transport *transport = &udp_tx_transports[count];
+
+		if (!(UDP_TX_AC_MASK & BIT(ac))) {
+			continue;
+		}
+
+		*stream = (struct udp_tx_stream){
+			.socket = -1,
+			.ac = ac,
+			.primary = count == 0,
+		};
+		*transport = (struct latency_transport){
+			.api = &udp_transport_api,
+			.name = IS_ENABLED(CONFIG_UDP_TX_DEV_WMM) ? udp_tx_stream_names[ac] : "UDP",
+			.trace_stream = TRACE_STREAM_UDP(ac),
+			.ctx = stream,
+		};
+		transports[count++] = transport;
+	}
+	udp_tx_stream_count = count;
+
+	return count;
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_TRANSPORT_UDP && CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_TX */
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRANSPORT_UDP) &&                                          \
+	IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_RX)
+#define UDP_RX_STACK_SIZE 4096
+#define UDP_RX_PRIORITY   K_PRIO_PREEMPT(0)
+
+/* One statistics table per sender, access category and traffic kind, so
+ * background bulk never mixes with the probes. Only the RX thread adds
+ * entries and looks them up, the reporter reads each table under its own
+ * spinlock.
+ */
+struct udp_rx_station {
+	bool used;
+	struct in_addr addr;
+	uint16_t station_id;
+	uint8_t ac;
+	bool bulk;
+	char name[40];
+	struct latency_stats stats;
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TIMESYNC)
+	/* Clock of the sender, shared by all its tables, NULL for udp-other */
+	struct timesync_clock *clock;
+#endif
+};
+
+static struct udp_rx_station udp_rx_stations[CONFIG_UDP_RX_DEV_MAX_STATIONS];
+static struct udp_rx_station udp_rx_other;
+static int udp_rx_socket = -1;
+static uint32_t udp_rx_packets;
+
+static void udp_rx_station_log(const struct udp_rx_station *station)
+{
+#if IS_ENABLED(CONFIG_UDP_RX_DEV_MODE_SOFTAP) && IS_ENABLED(CONFIG_WIFI_NM_WPA_SUPPLICANT_AP)
+	uint8_t mac[WIFI_MAC_ADDR_LEN];
+
+	/* Associated stations are known by MAC, match them to the DHCP lease */
+	if (softap_station_get_mac(&station->addr, mac) == 0) {
+		LOG_INF("New station %s, MAC %02x:%02x:%02x:%02x:%02x:%02x", station->name,
+			mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+		return;
+	}
+#endif
+	LOG_INF("New station %s", station->name);
+}
+
+static struct udp_rx_station *udp_rx_station_get(const struct in_addr *addr,
+						  const struct latency_probe *probe)
+{
+	bool bulk = probe->flags & LATENCY_PROBE_FLAG_BULK;
+	struct udp_rx_station *station = NULL;
+	char addr_str[NET_IPV4_ADDR_LEN];
+
+	for (int i = 0; i < ARRAY_SIZE(udp_rx_stations); i++) {
+		if (!udp_rx_stations[i].used) {
+			if (!station) {
+				station = &udp_rx_stations[i];
+			}
+			continue;
+		}
+		if (udp_rx_stations[i].station_id == probe->station_id &&
+		    udp_rx_stations[i].ac == probe->ac && udp_rx_stations[i].bulk == bulk &&
+		    net_ipv4_addr_cmp(&udp_rx_stations[i].addr, addr)) {
+			return &udp_rx_stations[i];
+		}
+	}
+
+	if (!station) {
+		if (!udp_rx_other.used) {
+			LOG_WRN("More than %d stations, the rest share one table",
+				CONFIG_UDP_RX_DEV_MAX_STATIONS);
+			latency_stats_init(&udp_rx_other.stats, "udp-other");
+			latency_stats_register(&udp_rx_other.stats);
+			udp_rx_other.used = true;
+		}
+		return &udp_rx_other;
+	}
+
+	net_addr_ntop(AF_INET, addr, addr_str, sizeof(addr_str));
+	snprintk(station->name, sizeof(station->name), "sta%u/%s/%s%s", probe->station_id,
+		 addr_str, udp_ac_name(probe->ac), bulk ? "/bulk" : "");
+	station->addr = *addr;
+	station->station_id = probe->station_id;
+	station->ac = probe->ac;
+	station->bulk = bulk;
+	station->used = true;
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TIMESYNC)
+	station->clock = timesync_clock_get(addr, probe->station_id);
+#endif
+	latency_stats_init(&station->stats, station->name);
+	latency_stats_register(&station->stats);
+	udp_rx_station_log(station);
+
+	return station;
+}
+
+static void udp_rx_handle_datagram(int socket, struct udp_rx_datagram *dgram, void *user_data)
+{
+	uint32_t *packet_count = user_data;
+	struct udp_rx_station *station;
+	struct latency_stats *udp_rx_stats;
+	struct latency_probe probe;
+	int64_t rx_us = k_cyc_to_us_floor64(dgram->rx_cycles);
+	int len = dgram->len;
+
+	if (udp_probe_decode(dgram->buf, len, &probe)) {
+		led_trigger_rx();
+		LOG_WRN("Received %d bytes that are not a latency probe", len);
+		return;
+	}
+
+	/* Sync exchanges are answered here and never counted as probes */
+	if (IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TIMESYNC) &&
+	    timesync_process(socket, &dgram->src, &probe, dgram->buf, len, rx_us)) {
+		return;
+	}
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_UDP_ECHO)
+	/* Reflect first to keep the turnaround out of the RTT */
+	if (probe.flags & LATENCY_PROBE_FLAG_ECHO_REQ) {
+		udp_probe_echo(socket, &dgram->src, dgram->buf, len);
+	}
+#endif
+
+	/* Trigger LED when packet received */
+	led_trigger_rx();
+	boot_mark(BOOT_PHASE_FIRST_PACKET);
+
+	station = udp_rx_station_get(&dgram->src.sin_addr, &probe);
+	udp_rx_stats = &station->stats;
+
+	/* Each throughput step gets its own summary */
+	latency_stats_set_tag(udp_rx_stats, probe.tag);
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TIMESYNC)
+	if (station->clock) {
+		int64_t offset_us;
+
+		/* One-way latency once this sender's clock is tracked */
+		if (timesync_get_offset(station->clock, rx_us, &offset_us)) {
+			latency_stats_set_clock_offset(udp_rx_stats, offset_us);
+		}
+	}
+#endif
+	latency_stats_update(udp_rx_stats, probe.seq, k_cyc_to_us_floor64(probe.tx_cycles), rx_us,
+			     len);
+	if (probe.burst_len > 1) {
+		latency_stats_update_burst(udp_rx_stats, probe.seq, probe.burst_idx,
+					   probe.burst_len, len,
+					   k_cyc_to_us_floor64(probe.tx_cycles), rx_us);
+	}
+
+	if (IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_TRACE)) {
+		trace_utils_record(TRACE_EVT_RX, TRACE_STREAM_UDP(probe.ac), probe.seq,
+				   dgram->rx_cycles, 0, len);
+	} else if (!IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_THROUGHPUT) &&
+		   !(probe.flags & LATENCY_PROBE_FLAG_BULK)) {
+		LOG_INF("Received: seq %u, %d bytes at %lld ms", probe.seq, len,
+			rx_us / USEC_PER_MSEC);
+	}
+	(*packet_count)++;
+}
+
+static void udp_rx_thread(void *p1, void *p2, void *p3)
+{
+	static uint8_t buffer[MAX(256, LATENCY_PROBE_MAX_LEN)];
+	int ret;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	/* Main reception loop, every wakeup drains all queued datagrams */
+	while (1) {
+		ret = udp_receive_batch(udp_rx_socket, buffer, sizeof(buffer), -1,
+					udp_rx_handle_datagram, &udp_rx_packets);
+		if (ret < 0) {
+			LOG_ERR("Failed to receive UDP packet: %d", ret);
+			/* Back off briefly without stalling the datagrams behind the error */
+			k_sleep(K_MSEC(1));
+		}
+	}
+}
+
+K_THREAD_DEFINE(udp_rx_tid, UDP_RX_STACK_SIZE, udp_rx_thread, NULL, NULL, NULL, UDP_RX_PRIORITY,
+		0, K_TICKS_FOREVER);
+
+static int udp_transport_recv(struct latency_transport *transport)
+{
+	int ret;
+
+	/* Create UDP socket for receiving */
+	ret = udp_server_init(&udp_rx_socket, CONFIG_WIFI_LATENCY_TEST_SOCKET_PORT);
+	if (ret) {
+		LOG_ERR("Failed to initialize UDP server: %d", ret);
+		return ret;
+	}
+
+	ret = udp_server_enable_timestamps(udp_rx_socket);
+	if (ret) {
+		LOG_WRN("Using software RX timestamps: %d", ret);
+	}
+
+	LOG_INF("UDP server listening on port %d", CONFIG_WIFI_LATENCY_TEST_SOCKET_PORT);
+	ps_print_config();
+	pool_monitor_set_socket(udp_rx_socket);
+
+	k_thread_name_set(udp_rx_tid, "udp_rx");
+	k_thread_start(udp_rx_tid);
+	return 0;
+}
+
+static const struct latency_transport_api udp_transport_api = {
+	.recv = udp_transport_recv,
+};
+
+static struct latency_transport udp_rx_transport = {
+	.api = &udp_transport_api,
+	.name = "UDP",
+};
+
+int udp_transports_get(struct latency_transport **transports, int max)
+{
+	if (max < 1) {
+		return 0;
+	}
+
+	transports[0] = &udp_rx_transport;
+	return 1;
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_TRANSPORT_UDP && CONFIG_WIFI_LATENCY_TEST_DEVICE_ROLE_RX */
@@ -10,6 +10,64 @@
 #include <zephyr/kernel.h>
 #include <zephyr/net/socket.h>
 
+#include "engine_utils.h"
+
+/* Binary latency probe carried at the start of every UDP test datagram */
+#define LATENCY_PROBE_MAGIC   0x5054414CU /* "LATP" on the wire */
+#define LATENCY_PROBE_VERSION 5
+
+/* Probe flags */
+#define LATENCY_PROBE_FLAG_ECHO_REQ       BIT(0) /* Receiver should reflect the probe */
+#define LATENCY_PROBE_FLAG_ECHO_REPLY     BIT(1) /* Probe is a reflected reply */
+#define LATENCY_PROBE_FLAG_SYNC_REQ       BIT(2) /* Time sync request, see timesync_utils.h */
+#define LATENCY_PROBE_FLAG_SYNC_REPLY     BIT(3) /* Time sync reply */
+#define LATENCY_PROBE_FLAG_SYNC_FOLLOW_UP BIT(4) /* Time sync follow-up with all timestamps */
+#define LATENCY_PROBE_FLAG_BULK           BIT(5) /* Background load, not a latency probe */
+#define LATENCY_PROBE_FLAG_SYNC_MASK                                                               \
+	(LATENCY_PROBE_FLAG_SYNC_REQ | LATENCY_PROBE_FLAG_SYNC_REPLY |                             \
+	 LATENCY_PROBE_FLAG_SYNC_FOLLOW_UP)
+
+/* Probe header, all fields little-endian on the wire */
+struct latency_probe_hdr {
+	uint32_t magic;
+	uint8_t version;
+	uint8_t flags;
+	uint16_t payload_len; /* Bytes following the header */
+	uint32_t seq;
+	uint64_t tx_cycles;  /* k_cycle_get_64() on the sender */
+	uint8_t burst_idx;   /* Position in the burst, 0 for the first probe */
+	uint8_t burst_len;   /* Probes in the burst, 1 when not bursting */
+	uint16_t tag;        /* Test phase, e.g. throughput step; 0 when untagged */
+	uint16_t station_id; /* Sender ID, lets a SoftAP RX tell its stations apart */
+	uint8_t ac;          /* Access category of the probe stream, enum udp_ac */
+} __packed;
+
+/* Largest probe sent by this build, header plus configured padding */
+#define LATENCY_PROBE_MAX_LEN                                                                      \
+	(sizeof(struct latency_probe_hdr) + CONFIG_WIFI_LATENCY_TEST_PAYLOAD_SIZE)
+
+/* Decoded probe in host byte order */
+struct latency_probe {
+	uint8_t flags;
+	uint16_t payload_len;
+	uint32_t seq;
+	uint64_t tx_cycles;
+	uint8_t burst_idx;
+	uint8_t burst_len;
+	uint16_t tag;
+	uint16_t station_id;
+	uint8_t ac;
+};
+
+/* WMM access categories, numbered like the raw TX queues (RAW_TX_DEV_QUEUE_NUM) */
+enum udp_ac {
+	UDP_AC_BK,
+	UDP_AC_BE,
+	UDP_AC_VI,
+	UDP_AC_VO,
+	UDP_AC_COUNT,
+};
+
 /**
  * @brief Initialize UDP client
  *
@@ -22,6 +80,27 @@
 int udp_client_init(int *socket, struct sockaddr_in *server_addr, const char *target_ip,
 		    uint16_t port);
 
+/**
+ * @brief Map a UDP client socket to a WMM access category
+ *
+ * Sets SO_PRIORITY, which selects the network stack TX traffic class, and
+ * the IP_TOS DSCP, from which the nRF70 driver derives the 802.11 user
+ * priority and so the hardware queue.
+ *
+ * @param socket Socket descriptor
+ * @param ac Access category, enum udp_ac
+ * @return 0 on success, negative error code on failure
+ */
+int udp_client_set_ac(int socket, uint8_t ac);
+
+/**
+ * @brief Get the short name of an access category
+ *
+ * @param ac Access category, enum udp_ac
+ * @return "BK", "BE", "VI", "VO" or "??"
+ */
+const char *udp_ac_name(uint8_t ac);
+
 /**
  * @brief Initialize UDP server
  *
@@ -52,6 +131,129 @@ int udp_send(int socket, struct sockaddr_in *server_addr, const char *data, size
  */
 int udp_receive(int socket, char *buffer, size_t buffer_size);
 
+/**
+ * @brief Receive UDP packet and report its source address
+ *
+ * @param socket Socket descriptor
+ * @param buffer Buffer to store received data
+ * @param buffer_size Size of the buffer
+ * @param src_addr Filled with the sender address
+ * @return Number of bytes received on success, 0 on timeout, negative error code on failure
+ */
+int udp_receive_from(int socket, char *buffer, size_t buffer_size, struct sockaddr_in *src_addr);
+
+/* Datagram handed to a udp_receive_batch() handler */
+struct udp_rx_datagram {
+	uint8_t *buf;           /* Datagram, may be modified in place by the handler */
+	size_t len;
+	struct sockaddr_in src; /* Sender address */
+	uint64_t rx_cycles;     /* Receive time, k_cycle_get_64() base */
+	bool stack_ts;          /* rx_cycles came from the network stack, not recvmsg() */
+};
+
+typedef void (*udp_rx_handler_t)(int socket, struct udp_rx_datagram *dgram, void *user_data);
+
+/**
+ * @brief Enable network stack RX timestamps on a server socket
+ *
+ * Only has an effect with CONFIG_UDP_RX_DEV_RX_TIMESTAMPING.
+ *
+ * @param socket Socket descriptor
+ * @return 0 on success, negative error code on failure
+ */
+int udp_server_enable_timestamps(int socket);
+
+/**
+ * @brief Wait for datagrams and drain the receive queue
+ *
+ * Polls the socket, then reads datagrams without blocking until the queue is
+ * empty or CONFIG_UDP_RX_DEV_BATCH_MAX have been read. Each datagram is
+ * timestamped right after its read returns and passed to the handler before
+ * the next read, so buf is reused.
+ *
+ * @param socket Socket descriptor
+ * @param buf Receive buffer
+ * @param buf_size Size of the receive buffer
+ * @param timeout_ms Poll timeout in milliseconds, -1 to wait forever
+ * @param handler Called for every datagram
+ * @param user_data Passed to the handler
+ * @return Number of datagrams handled, 0 on timeout, negative error code on failure
+ */
+int udp_receive_batch(int socket, uint8_t *buf, size_t buf_size, int timeout_ms,
+		      udp_rx_handler_t handler, void *user_data);
+
+/**
+ * @brief Prepare a UDP client socket to receive echo replies
+ *
+ * Binds the socket to an ephemeral port and sets a receive timeout.
+ *
+ * @param socket Socket descriptor
+ * @param timeout_ms Receive timeout in milliseconds
+ * @return 0 on success, negative error code on failure
+ */
+int udp_client_enable_replies(int socket, int timeout_ms);
+
+/**
+ * @brief Reflect a received probe back to its sender
+ *
+ * Marks the probe as an echo reply in place and sends it unchanged otherwise,
+ * so the original TX timestamp is preserved.
+ *
+ * @param socket Socket descriptor
+ * @param dst_addr Address of the original sender
+ * @param buf Received probe datagram
+ * @param len Length of the datagram
+ * @return Number of bytes sent on success, negative error code on failure
+ */
+int udp_probe_echo(int socket, struct sockaddr_in *dst_addr, uint8_t *buf, size_t len);
+
+/**
+ * @brief Encode a latency probe into a datagram buffer
+ *
+ * Writes the header and zero-fills probe->payload_len bytes of payload after it.
+ *
+ * @param buf Destination buffer
+ * @param buf_size Size of the destination buffer
+ * @param probe Probe fields to encode
+ * @return Datagram length on success, negative error code on failure
+ */
+int udp_probe_encode(uint8_t *buf, size_t buf_size, const struct latency_probe *probe);
+
+/**
+ * @brief Decode a latency probe from a received datagram
+ *
+ * @param buf Received datagram
+ * @param len Length of the received datagram
+ * @param probe Decoded probe fields
+ * @return 0 on success, negative error code if the datagram is not a valid probe
+ */
+int udp_probe_decode(const uint8_t *buf, size_t len, struct latency_probe *probe);
+
+/**
+ * @brief Get the station ID carried in every probe
+ *
+ * CONFIG_UDP_TX_DEV_STATION_ID, or the last two bytes of the Wi-Fi MAC
+ * address when that is 0 or the image has no UDP transport.
+ *
+ * @return Station ID
+ */
+uint16_t udp_tx_station_id(void);
+
+/**
+ * @brief Get the UDP transports of the latency engine
+ *
+ * On a TX device one transport per probe stream, i.e. per access category
+ * of CONFIG_UDP_TX_DEV_AC_MASK with CONFIG_UDP_TX_DEV_WMM, each with its own
+ * socket. The first stream also receives echo replies and runs the clock
+ * synchronization. On an RX device a single transport whose recv() starts
+ * the UDP server thread.
+ *
+ * @param transports Filled with the transports
+ * @param max Size of the transports array
+ * @return Number of transports
+ */
+int udp_transports_get(struct latency_transport **transports, int max);
+
 /**
  * @brief Cleanup UDP client
  *
@@ -13,6 +13,9 @@
 #include <zephyr/net/dhcpv4.h>
 #include <zephyr/net/dhcpv4_server.h>
 #include <zephyr/net/socket.h>
+#include <zephyr/net/wifi_credentials.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/atomic.h>
 #include <string.h>
 
 #include "wifi_utils.h"
@@ -289,3 +292,190 @@ void wifi_print_dhcp_ip(struct net_mgmt_event_callback *cb)
 	net_addr_ntop(AF_INET, addr, dhcp_info, sizeof(dhcp_info));
 	LOG_INF("\r\n\r\nDevice IP address: %s\r\n", dhcp_info);
 }
+
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_FAST_CONNECT)
+#define LINK_CACHE_SETTINGS_NAME "latency/link"
+#define LINK_CACHE_VERSION       1
+
+/* Stored blob, the version discards data written by an older layout */
+struct wifi_link_cache {
+	uint8_t version;
+	uint8_t ssid_len;
+	char ssid[WIFI_SSID_MAX_LEN];
+	uint8_t bssid[WIFI_MAC_ADDR_LEN];
+	uint8_t channel;
+	uint8_t band;
+};
+
+static struct wifi_link_cache link_cache;
+static bool link_cache_valid;
+/* Outcome of the last connection attempt, handled off the net_mgmt callback */
+static atomic_t link_cache_connected;
+
+static void link_cache_work_handler(struct k_work *work);
+static K_WORK_DEFINE(link_cache_work, link_cache_work_handler);
+
+static int link_cache_settings_set(const char *name, size_t len, settings_read_cb read_cb,
+				   void *cb_arg)
+{
+	struct wifi_link_cache store;
+	int ret;
+
+	if (name && name[0] != '\0') {
+		return -ENOENT;
+	}
+
+	if (len != sizeof(store)) {
+		LOG_WRN("Ignoring cached link of size %zu", len);
+		return 0;
+	}
+
+	ret = read_cb(cb_arg, &store, sizeof(store));
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (store.version != LINK_CACHE_VERSION || store.ssid_len > WIFI_SSID_MAX_LEN) {
+		LOG_WRN("Ignoring invalid cached link");
+		return 0;
+	}
+
+	link_cache = store;
+	link_cache_valid = true;
+	return 0;
+}
+
+/* Loaded together with the test parameters by params_init() */
+SETTINGS_STATIC_HANDLER_DEFINE(latency_link, LINK_CACHE_SETTINGS_NAME, NULL,
+			       link_cache_settings_set, NULL, NULL);
+
+static uint32_t link_cache_band_flag(uint8_t band)
+{
+	switch (band) {
+	case WIFI_FREQ_BAND_2_4_GHZ:
+		return WIFI_CREDENTIALS_FLAG_2_4GHz;
+	case WIFI_FREQ_BAND_5_GHZ:
+		return WIFI_CREDENTIALS_FLAG_5GHz;
+	default:
+		return 0;
+	}
+}
+
+static int link_cache_set_credentials(bool pin)
+{
+	struct wifi_credentials_personal creds;
+	int ret;
+
+	ret = wifi_credentials_get_by_ssid_personal_struct(link_cache.ssid, link_cache.ssid_len,
+							   &creds);
+	if (ret) {
+		LOG_WRN("No credentials for cached SSID %.*s: %d", link_cache.ssid_len,
+			link_cache.ssid, ret);
+		return ret;
+	}
+
+	creds.header.flags &= ~(WIFI_CREDENTIALS_FLAG_BSSID | WIFI_CREDENTIALS_FLAG_2_4GHz |
+				WIFI_CREDENTIALS_FLAG_5GHz);
+	creds.header.channel = 0;
+	memset(creds.header.bssid, 0, sizeof(creds.header.bssid));
+	if (pin) {
+		creds.header.flags |=
+			WIFI_CREDENTIALS_FLAG_BSSID | link_cache_band_flag(link_cache.band);
+		creds.header.channel = link_cache.channel;
+		memcpy(creds.header.bssid, link_cache.bssid, sizeof(creds.header.bssid));
+	}
+
+	return wifi_credentials_set_personal_struct(&creds);
+}
+
+int wifi_link_cache_apply(void)
+{
+	int ret;
+
+	if (!link_cache_valid) {
+		LOG_INF("No cached link, connecting with a full scan");
+		return -ENOENT;
+	}
+
+	ret = link_cache_set_credentials(true);
+	if (ret) {
+		return ret;
+	}
+
+	LOG_INF("Fast connect to %02x:%02x:%02x:%02x:%02x:%02x on channel %u", link_cache.bssid[0],
+		link_cache.bssid[1], link_cache.bssid[2], link_cache.bssid[3], link_cache.bssid[4],
+		link_cache.bssid[5], link_cache.channel);
+	return 0;
+}
+
+static void link_cache_store(void)
+{
+	struct net_if *iface = net_if_get_first_wifi();
+	struct wifi_iface_status status = {0};
+	struct wifi_link_cache store = {
+		.version = LINK_CACHE_VERSION,
+	};
+	int ret;
+
+	if (!iface || net_mgmt(NET_REQUEST_WIFI_IFACE_STATUS, iface, &status, sizeof(status)) ||
+	    status.state < WIFI_STATE_ASSOCIATED || status.iface_mode != WIFI_MODE_INFRA) {
+		return;
+	}
+
+	store.ssid_len = MIN(status.ssid_len, WIFI_SSID_MAX_LEN);
+	memcpy(store.ssid, status.ssid, store.ssid_len);
+	memcpy(store.bssid, status.bssid, sizeof(store.bssid));
+	store.channel = status.channel;
+	store.band = status.band;
+
+	if (link_cache_valid && memcmp(&store, &link_cache, sizeof(store)) == 0) {
+		return;
+	}
+
+	link_cache = store;
+	link_cache_valid = true;
+	ret = settings_save_one(LINK_CACHE_SETTINGS_NAME, &store, sizeof(store));
+	if (ret) {
+		LOG_WRN("Failed to store the link cache: %d", ret);
+	}
+	/* Reconnects within this boot take the fast path too */
+	link_cache_set_credentials(true);
+	LOG_INF("Cached link: channel %u", store.channel);
+}
+
+static void link_cache_drop(void)
+{
+	if (!link_cache_valid) {
+		return;
+	}
+
+	link_cache_set_credentials(false);
+	link_cache_valid = false;
+	settings_delete(LINK_CACHE_SETTINGS_NAME);
+	LOG_INF("Link cache dropped, next connection scans all channels");
+}
+
+/* Status query and flash writes block, keep them out of the event callbacks */
+static void link_cache_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	if (atomic_get(&link_cache_connected)) {
+		link_cache_store();
+	} else {
+		link_cache_drop();
+	}
+}
+
+void wifi_link_cache_update(void)
+{
+	atomic_set(&link_cache_connected, 1);
+	k_work_submit(&link_cache_work);
+}
+
+void wifi_link_cache_invalidate(void)
+{
+	atomic_set(&link_cache_connected, 0);
+	k_work_submit(&link_cache_work);
+}
+#endif /* CONFIG_WIFI_LATENCY_TEST_FAST_CONNECT */
@@ -61,4 +61,31 @@ int wifi_set_mode(int mode);
  */
 int wifi_set_tx_injection_mode(void);
 
+#if IS_ENABLED(CONFIG_WIFI_LATENCY_TEST_FAST_CONNECT)
+/**
+ * @brief Restrict the stored credentials to the cached BSSID and channel
+ *
+ * Call after the settings are loaded and before connecting, so the
+ * supplicant skips the full scan.
+ *
+ * @return 0 on success, -ENOENT if nothing is cached, other negative error code on failure
+ */
+int wifi_link_cache_apply(void);
+
+/**
+ * @brief Cache the BSSID and channel of the current connection
+ *
+ * Only records the request, the status query and the settings write run
+ * from the system work queue. Safe to call from net_mgmt event callbacks.
+ */
+void wifi_link_cache_update(void);
+
+/**
+ * @brief Drop the cached BSSID and channel, e.g. after a failed connection
+ *
+ * Deferred to the system work queue like wifi_link_cache_update().
+ */
+void wifi_link_cache_invalidate(void);
+#endif /* CONFIG_WIFI_LATENCY_TEST_FAST_CONNECT */
+
 #endif /* WIFI_UTILS_H */